@@ -1,13 +1,31 @@
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <limits.h>
 
+/*
+ * Map size. By default ROWS and COLS are read at run time: the built-in
+ * 20x20 map, or a generated one with --size WxH [--seed N], searched
+ * --reps times, so the pipeline can time each optimization level on maps
+ * bigger than the caches. Built with -DFIXED_GRID this is the original
+ * program, where ROWS, COLS and every array bound are compile-time
+ * constants the optimizer can fold; only --reps is accepted.
+ */
+#ifdef FIXED_GRID
 #define ROWS 20
 #define COLS 20
+#else
+static int rows = 20, cols = 20;
+#define ROWS rows
+#define COLS cols
+#endif
 #define MAX_NODES (ROWS * COLS)
+#define MAX_SIDE  8192   /* --size limit, keeps node counts in an int */
+#define WALL_PCT  20     /* generated maps: chance of a wall per cell */
+#define PRINT_MAX 64     /* larger maps are not drawn */
 
 /* 0 = open, 1 = wall — same grid as Dijkstra */
-static const int grid[ROWS][COLS] = {
+static const int grid20[20][20] = {
     {0,0,0,0,0,1,0,0,0,0,0,0,0,0,1,0,0,0,0,0},
     {0,1,1,0,0,1,0,1,1,0,1,1,0,0,1,0,1,1,0,0},
     {0,1,0,0,0,0,0,0,1,0,0,1,0,0,0,0,0,1,0,0},
@@ -30,8 +48,16 @@ static const int grid[ROWS][COLS] = {
     {0,0,1,0,0,0,1,0,0,0,0,1,0,0,0,0,0,0,0,0},
 };
 
+#ifdef FIXED_GRID
+#define CELL(r, c) grid20[r][c]
+#else
+static unsigned char *grid;   /* ROWS x COLS, row-major */
+#define CELL(r, c) grid[(r) * COLS + (c)]
+#endif
+
 static const int START_R = 0, START_C = 0;
-static const int END_R = 19, END_C = 19;
+#define END_R (ROWS - 1)
+#define END_C (COLS - 1)
 
 /* Direction offsets: up, down, left, right */
 static const int DR[4] = {-1, 1, 0, 0};
@@ -42,15 +68,28 @@ typedef struct {
     int f_cost;  /* f = g + h */
 } HeapEntry;
 
-static HeapEntry heap[MAX_NODES];
+/* Search state: static arrays in the fixed build, sized by setup()
+ * otherwise. A node is pushed again whenever its g improves, at most once
+ * per in-edge, so the heap gets four entries per node. */
+#define HEAP_CAP (MAX_NODES * 4)
+#ifdef FIXED_GRID
+static HeapEntry heap[HEAP_CAP];
+static int g_cost[MAX_NODES];   /* cost from start */
+static int parent[MAX_NODES];
+static int closed[MAX_NODES];
+#else
+static HeapEntry *heap;
+static int *g_cost, *parent, *closed;
+#endif
 static int heap_size = 0;
+static int reps = 1;
 
 static inline int get_index(int r, int c) {
     return r * COLS + c;
 }
 
 static inline int is_valid(int r, int c) {
-    return r >= 0 && r < ROWS && c >= 0 && c < COLS && grid[r][c] == 0;
+    return r >= 0 && r < ROWS && c >= 0 && c < COLS && CELL(r, c) == 0;
 }
 
 static int heuristic(int r, int c) {
@@ -99,10 +138,82 @@ static HeapEntry heap_pop(void) {
     return top;
 }
 
-int main(void) {
-    int g_cost[MAX_NODES];   /* cost from start */
-    int parent[MAX_NODES];
-    int closed[MAX_NODES];
+static void usage(const char *prog) {
+#ifdef FIXED_GRID
+    fprintf(stderr, "Usage: %s [--reps N]\n", prog);
+#else
+    fprintf(stderr, "Usage: %s [--size WxH] [--seed N] [--reps N]\n", prog);
+#endif
+    exit(1);
+}
+
+#ifndef FIXED_GRID
+/* splitmix64, so a seed gives the same map on every build and libc */
+static unsigned long long next_random(unsigned long long *state) {
+    unsigned long long z = (*state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+#endif
+
+/* Parse the arguments; without FIXED_GRID also build the map (the
+ * built-in one unless --size or --seed is given) and size the arrays */
+static void setup(int argc, char *argv[]) {
+#ifndef FIXED_GRID
+    int generate = 0;
+    unsigned long long seed = 1;
+#endif
+    for (int a = 1; a < argc; a++) {
+        if (strcmp(argv[a], "--reps") == 0 && a + 1 < argc) {
+            reps = atoi(argv[++a]);
+#ifndef FIXED_GRID
+        } else if (strcmp(argv[a], "--size") == 0 && a + 1 < argc) {
+            const char *size = argv[++a];
+            if (sscanf(size, "%dx%d", &cols, &rows) != 2)
+                rows = cols = atoi(size);
+            generate = 1;
+        } else if (strcmp(argv[a], "--seed") == 0 && a + 1 < argc) {
+            seed = strtoull(argv[++a], NULL, 0);
+            generate = 1;
+#endif
+        } else {
+            usage(argv[0]);
+        }
+    }
+    if (reps < 1)
+        usage(argv[0]);
+
+#ifndef FIXED_GRID
+    if (rows < 3 || cols < 3 || rows > MAX_SIDE || cols > MAX_SIDE)
+        usage(argv[0]);
+    size_t n = (size_t)MAX_NODES;
+    grid = malloc(n);
+    heap = malloc((size_t)HEAP_CAP * sizeof(*heap));
+    g_cost = malloc(n * sizeof(*g_cost));
+    parent = malloc(n * sizeof(*parent));
+    closed = malloc(n * sizeof(*closed));
+    if (!grid || !heap || !g_cost || !parent || !closed) {
+        fprintf(stderr, "out of memory for a %dx%d map\n", COLS, ROWS);
+        exit(1);
+    }
+    for (int r = 0; r < ROWS; r++)
+        for (int c = 0; c < COLS; c++)
+            CELL(r, c) = generate ? next_random(&seed) % 100 < WALL_PCT : grid20[r][c];
+
+    /* Clear the corners of a generated map, so start and end are almost
+     * never walled in */
+    for (int r = 0; generate && r < 3; r++) {
+        for (int c = 0; c < 3; c++) {
+            CELL(START_R + r, START_C + c) = 0;
+            CELL(END_R - r, END_C - c) = 0;
+        }
+    }
+#endif
+}
+
+/* One search from start to end; returns the number of nodes explored */
+static int search(int start, int end) {
     int nodes_explored = 0;
 
     for (int i = 0; i < MAX_NODES; i++) {
@@ -111,8 +222,7 @@ int main(void) {
         closed[i] = 0;
     }
 
-    int start = get_index(START_R, START_C);
-    int end = get_index(END_R, END_C);
+    heap_size = 0;
     g_cost[start] = 0;
     int h = heuristic(START_R, START_C);
     heap_push(start, h);
@@ -144,40 +254,58 @@ int main(void) {
             }
         }
     }
+    return nodes_explored;
+}
 
-    /* Reconstruct path */
-    char path_grid[ROWS][COLS];
-    for (int r = 0; r < ROWS; r++)
-        for (int c = 0; c < COLS; c++)
-            path_grid[r][c] = grid[r][c] ? '#' : '.';
+int main(int argc, char *argv[]) {
+    setup(argc, argv);
+
+    int start = get_index(START_R, START_C);
+    int end = get_index(END_R, END_C);
+
+    /* Every repetition does the same work; the total keeps them all live */
+    int nodes_explored = 0;
+    long long total_explored = 0;
+    for (int rep = 0; rep < reps; rep++) {
+        nodes_explored = search(start, end);
+        total_explored += nodes_explored;
+    }
 
     int path_len = 0;
-    if (g_cost[end] != INT_MAX) {
-        int cur = end;
-        while (cur != -1) {
-            int r = cur / COLS;
-            int c = cur % COLS;
-            path_grid[r][c] = '*';
-            cur = parent[cur];
+    if (g_cost[end] != INT_MAX)
+        for (int cur = end; cur != -1; cur = parent[cur])
             path_len++;
+
+    printf("A* Pathfinding (%dx%d grid)\n", COLS, ROWS);
+    printf("------------------------------------------\n");
+    if (ROWS <= PRINT_MAX && COLS <= PRINT_MAX) {
+        /* Reconstruct path */
+        char path_grid[ROWS][COLS];
+        for (int r = 0; r < ROWS; r++)
+            for (int c = 0; c < COLS; c++)
+                path_grid[r][c] = CELL(r, c) ? '#' : '.';
+
+        if (g_cost[end] != INT_MAX) {
+            for (int cur = end; cur != -1; cur = parent[cur])
+                path_grid[cur / COLS][cur % COLS] = '*';
         }
-    }
 
-    path_grid[START_R][START_C] = 'S';
-    path_grid[END_R][END_C] = 'E';
+        path_grid[START_R][START_C] = 'S';
+        path_grid[END_R][END_C] = 'E';
 
-    /* Print grid */
-    printf("A* Pathfinding (%dx%d grid)\n", ROWS, COLS);
-    printf("------------------------------------------\n");
-    for (int r = 0; r < ROWS; r++) {
-        for (int c = 0; c < COLS; c++)
-            putchar(path_grid[r][c]);
-        putchar('\n');
+        /* Print grid */
+        for (int r = 0; r < ROWS; r++) {
+            for (int c = 0; c < COLS; c++)
+                putchar(path_grid[r][c]);
+            putchar('\n');
+        }
+        printf("------------------------------------------\n");
     }
-    printf("------------------------------------------\n");
     printf("Path cost:      %d\n", g_cost[end] != INT_MAX ? g_cost[end] : -1);
     printf("Path length:    %d nodes\n", path_len);
     printf("Nodes explored: %d\n", nodes_explored);
+    if (reps > 1)
+        printf("Reps:           %d (%lld nodes explored)\n", reps, total_explored);
 
     return 0;
 }
@@ -11,9 +11,89 @@
 #   bash build_all.sh ida_star      # build only ida_star
 #   bash build_all.sh hello         # build only hello
 #   bash build_all.sh visualizer   # build only visualizer (SDL2, no LLVM pipeline)
+#   bash build_all.sh bench        # build only headless benchmark (no SDL, no LLVM pipeline)
+#   bash build_all.sh term         # build only the terminal front-end (no SDL, no LLVM pipeline)
+#   bash build_all.sh bench-pgo    # PGO build of the benchmark, timed against the plain one
+#   bash build_all.sh bench-lto    # full LTO and ThinLTO builds of the benchmark, timed the same way
+#   bash build_all.sh bench-bolt   # llvm-bolt layout pass over the PGO benchmark, timed against it
+#   PGO=1 bash build_all.sh dijkstra  # add the profile-guided stage to the pipeline
 
 set -e
 
+# Grid bound for the benchmark build (Moving AI maps are up to 1024x1024)
+BENCH_GRID="${BENCH_GRID:-1024}"
+BENCH_FLAGS="${BENCH_FLAGS:-}"
+
+# Profile-guided optimization: PGO=1 adds a stage to each pipeline target
+# (instrument, train, merge, rebuild at PGO_OPT). bench-pgo trains
+# rrrlz-bench with PGO_TRAIN. Training never uses the timed input: the
+# pipeline programs train on their workload generated with PGO_TRAIN_SEED
+# instead of the default seed, and rrrlz-bench on generated maps while
+# BENCH_COMPARE times the bundled ones.
+PGO="${PGO:-0}"
+PGO_OPT="${PGO_OPT:-O2}"
+PGO_TRAIN_SEED="${PGO_TRAIN_SEED:-2}"
+PGO_TRAIN="${PGO_TRAIN:---gen random:24x24,32x32 --gen maze:25x25 --gen rooms:32x32 --gen cave:32x24 --seed 7 --reps 3 --warmup 0 --no-mem}"
+
+# Post-link layout: bench-bolt profiles rrrlz-bench-pgo on BOLT_TRAIN and
+# rewrites it with llvm-bolt. BOLT_PROFILE picks the profile: lbr (perf
+# record with branch stacks), instrument (llvm-bolt -instrument) or auto
+# (lbr when perf can sample branches here, else instrument).
+BOLT_TRAIN="${BOLT_TRAIN:-$PGO_TRAIN}"
+BOLT_PROFILE="${BOLT_PROFILE:-auto}"
+
+# bench-pgo / bench-lto / bench-bolt time each variant against a reference
+# build (plain rrrlz-bench, or rrrlz-bench-pgo for bolt) with these arguments
+BENCH_COMPARE="${BENCH_COMPARE:---reps 10 --no-mem}"
+
+# Runtime table: every pipeline binary runs RUNS times on its workload
+# (median wall time taken) and once under perf stat for instructions
+# retired. RUNS=0 skips the table.
+RUNS="${RUNS:-5}"
+RUN_ARGS="${RUN_ARGS:-}"
+
+# The pipeline programs read --size/--seed/--reps; FIXED_GRID=1 builds
+# their compile-time 20x20 variant instead (-DFIXED_GRID)
+FIXED_GRID="${FIXED_GRID:-0}"
+GRID_FLAGS=""
+if [ "$FIXED_GRID" -eq 1 ]; then
+    GRID_FLAGS="-DFIXED_GRID"
+fi
+
+# Workload for the runtime table: a generated map the search outgrows the
+# caches on, or with FIXED_GRID the 20x20 map repeated. RUN_ARGS replaces
+# it for every program.
+run_args() {
+    if [ -n "$RUN_ARGS" ]; then
+        echo "$RUN_ARGS"
+    elif [ "$FIXED_GRID" -eq 1 ]; then
+        case "$1" in
+            floyd_warshall) echo "--reps 20" ;;
+            hello) ;;
+            *)              echo "--reps 20000" ;;
+        esac
+    else
+        case "$1" in
+            dijkstra)       echo "--size 1024 --reps 3" ;;
+            astar)          echo "--size 1024 --reps 10" ;;
+            bellman_ford)   echo "--size 1024" ;;
+            floyd_warshall) echo "--size 32" ;;
+            ida_star)       echo "--size 48 --reps 50" ;;
+        esac
+    fi
+}
+
+# PGO training workload: the timed one on another generated map. FIXED_GRID
+# programs only have their built-in map, so they train on it.
+train_args() {
+    local args=$(run_args "$1")
+    if [ "$FIXED_GRID" -eq 1 ] || [ -z "$args" ]; then
+        echo "$args"
+    else
+        echo "$args --seed $PGO_TRAIN_SEED"
+    fi
+}
+
 build_one() {
     local src="$1"
     local dir="$(dirname "$src")"
@@ -27,7 +107,7 @@ build_one() {
 
     echo ""
     echo "=== Step 0: Unoptimized IR (clean, no optnone/noinline) ==="
-    clang -S -emit-llvm -O1 -Xclang -disable-llvm-optzns "$src" -o "${prefix}_O0.ll"
+    clang -S -emit-llvm -O1 -Xclang -disable-llvm-optzns $GRID_FLAGS "$src" -o "${prefix}_O0.ll"
     echo "  -> ${prefix}_O0.ll"
 
     for OPT in O1 O2 O3 Os Oz; do
@@ -50,27 +130,278 @@ build_one() {
     echo ""
     echo "=== Direct clang builds for comparison ==="
     for OPT in O0 O1 O2 O3 Os Oz; do
-        clang -${OPT} "$src" -o "${prefix}_clang_${OPT}"
+        clang -${OPT} $GRID_FLAGS "$src" -o "${prefix}_clang_${OPT}"
         echo "  -> ${prefix}_clang_${OPT}"
     done
+
+    if [ "$PGO" -eq 1 ]; then
+        build_pgo "$src"
+    fi
+}
+
+# Instrumented build, a training run, then the same clean IR -> opt -> llc
+# pipeline with the profile's branch weights and entry counts attached, so
+# ${prefix}_pgo_O2.ll diffs directly against ${prefix}_opt_O2.ll
+build_pgo() {
+    local src="$1"
+    local dir="$(dirname "$src")"
+    local base="$(basename "$src" .c)"
+    local prefix="${dir}/${base}"
+
+    echo ""
+    echo "=== PGO: instrumented build ==="
+    clang -${PGO_OPT} -fprofile-instr-generate $GRID_FLAGS "$src" -o "${prefix}_pgo_gen"
+    echo "  -> ${prefix}_pgo_gen"
+
+    echo ""
+    local args=$(train_args "$base")
+    echo "=== PGO: training run${args:+ ($args)} ==="
+    rm -f "${prefix}"_pgo_*.profraw
+    LLVM_PROFILE_FILE="${prefix}_pgo_%p.profraw" "./${prefix}_pgo_gen" $args > /dev/null
+    llvm-profdata merge -o "${prefix}.profdata" "${prefix}"_pgo_*.profraw
+    rm -f "${prefix}"_pgo_*.profraw
+    echo "  -> ${prefix}.profdata"
+
+    echo ""
+    echo "=== PGO: optimizing IR at -${PGO_OPT} with the profile ==="
+    clang -S -emit-llvm -O1 -Xclang -disable-llvm-optzns $GRID_FLAGS \
+        -fprofile-instr-use="${prefix}.profdata" "$src" -o "${prefix}_pgo_O0.ll"
+    opt -S -${PGO_OPT} "${prefix}_pgo_O0.ll" -o "${prefix}_pgo_${PGO_OPT}.ll"
+    llc -relocation-model=pic "${prefix}_pgo_${PGO_OPT}.ll" -o "${prefix}_pgo_${PGO_OPT}.s"
+    clang "${prefix}_pgo_${PGO_OPT}.s" -o "${prefix}_pgo_${PGO_OPT}"
+    echo "  -> ${prefix}_pgo_${PGO_OPT}.ll"
+    echo "  -> ${prefix}_pgo_${PGO_OPT}.s"
+    echo "  -> ${prefix}_pgo_${PGO_OPT}"
+}
+
+# Median wall time of RUNS runs of a command, in microseconds
+median_us() {
+    local times=()
+    for ((i = 0; i < RUNS; i++)); do
+        local t0=$(date +%s%N)
+        "$@" > /dev/null
+        local t1=$(date +%s%N)
+        times+=($(( (t1 - t0) / 1000 )))
+    done
+    printf "%s\n" "${times[@]}" | sort -n | sed -n "$(( (RUNS + 1) / 2 ))p"
+}
+
+# Count of one perf event over one run of a command, or "-" without perf,
+# with perf_event_paranoid too high, or when the CPU lacks the event
+perf_count() {
+    local event="$1"; shift
+    local out=$(mktemp)
+    local n="-"
+    if command -v perf > /dev/null &&
+       perf stat -x, -e "$event" -o "$out" -- "$@" > /dev/null 2>&1; then
+        n=$(awk -F, -v ev="$event" '$3 == ev { print $1 }' "$out")
+        [[ "$n" =~ ^[0-9]+$ ]] || n="-"
+    fi
+    rm -f "$out"
+    echo "$n"
+}
+
+# User-space instructions retired by one run of a command
+instructions() {
+    perf_count instructions:u "$@"
 }
 
+ALGO_SRC=(visualizer/algo_*.c visualizer/trace.c visualizer/heat.c)
+BENCH_SRC=(visualizer/bench.c visualizer/workload.c visualizer/map_io.c visualizer/mapgen.c
+           visualizer/map_info.c visualizer/replay.c "${ALGO_SRC[@]}")
+BENCH_BUILT=0
+BENCH_PLAIN_SAVED=0
+
 build_visualizer() {
     echo ""
     echo "============================================"
     echo "  Building: visualizer (SDL2)"
     echo "============================================"
-    clang -O2 visualizer/visualizer.c -o visualizer/visualizer \
-        $(pkg-config --cflags --libs sdl2)
+    clang -O2 visualizer/visualizer.c visualizer/lod.c visualizer/map_info.c visualizer/replay.c "${ALGO_SRC[@]}" -o visualizer/visualizer \
+        $(pkg-config --cflags --libs sdl2) -lm
     echo "  -> visualizer/visualizer"
 }
 
+build_bench() {
+    echo ""
+    echo "============================================"
+    echo "  Building: rrrlz-bench (headless)"
+    echo "============================================"
+    clang -O2 -DMAX_ROWS="$BENCH_GRID" -DMAX_COLS="$BENCH_GRID" $BENCH_FLAGS \
+        "${BENCH_SRC[@]}" -o visualizer/rrrlz-bench -lm
+    echo "  -> visualizer/rrrlz-bench"
+    BENCH_BUILT=1
+}
+
+# Time a build variant of rrrlz-bench against a reference build (the plain
+# one by default) on BENCH_COMPARE: the reference run is saved as a
+# baseline and the variant compared against it, one row per algorithm x
+# map. The plain baseline is only recorded once per script run.
+bench_compare() {
+    local variant="$1"
+    local ref="${2:-visualizer/rrrlz-bench}"
+    local csv="$ref-base.csv"
+    if [ "$ref" = visualizer/rrrlz-bench ]; then
+        csv=visualizer/rrrlz-bench-plain.csv
+        if [ "$BENCH_PLAIN_SAVED" -eq 0 ]; then
+            [ "$BENCH_BUILT" -eq 1 ] || build_bench
+            "./$ref" $BENCH_COMPARE --save-baseline "$csv" > /dev/null
+            BENCH_PLAIN_SAVED=1
+        fi
+    else
+        "./$ref" $BENCH_COMPARE --save-baseline "$csv" > /dev/null
+    fi
+    echo ""
+    echo "=== $(basename "$ref") vs $(basename "$variant") ($BENCH_COMPARE) ==="
+    # Exit status 1 only means some pair got slower; the table says which
+    "./$variant" $BENCH_COMPARE --baseline "$csv" | sed -n '/^Baseline:/,$p' || true
+}
+
+build_term() {
+    echo ""
+    echo "============================================"
+    echo "  Building: rrrlz-term (terminal)"
+    echo "============================================"
+    clang -O2 -DMAX_ROWS="$BENCH_GRID" -DMAX_COLS="$BENCH_GRID" $BENCH_FLAGS \
+        visualizer/term.c visualizer/lod.c visualizer/map_io.c visualizer/mapgen.c visualizer/map_info.c "${ALGO_SRC[@]}" \
+        -o visualizer/rrrlz-term -lm
+    echo "  -> visualizer/rrrlz-term"
+}
+
+# rrrlz-bench built with a profile of itself running PGO_TRAIN, then timed
+# against the plain build
+build_bench_pgo() {
+    echo ""
+    echo "============================================"
+    echo "  Building: rrrlz-bench-pgo (profile-guided)"
+    echo "============================================"
+    clang -O2 -fprofile-instr-generate -DMAX_ROWS="$BENCH_GRID" -DMAX_COLS="$BENCH_GRID" $BENCH_FLAGS \
+        "${BENCH_SRC[@]}" -o visualizer/rrrlz-bench-pgo-gen -lm
+    echo "  -> visualizer/rrrlz-bench-pgo-gen"
+
+    rm -f visualizer/rrrlz-bench-*.profraw
+    LLVM_PROFILE_FILE="visualizer/rrrlz-bench-%p.profraw" \
+        ./visualizer/rrrlz-bench-pgo-gen $PGO_TRAIN > /dev/null
+    llvm-profdata merge -o visualizer/rrrlz-bench.profdata visualizer/rrrlz-bench-*.profraw
+    rm -f visualizer/rrrlz-bench-*.profraw
+    echo "  -> visualizer/rrrlz-bench.profdata (trained on: $PGO_TRAIN)"
+
+    # --emit-relocs keeps the relocations llvm-bolt needs to move code
+    # (bench-bolt); they are not loaded, so the PGO binary runs the same
+    clang -O2 -fprofile-instr-use=visualizer/rrrlz-bench.profdata \
+        -DMAX_ROWS="$BENCH_GRID" -DMAX_COLS="$BENCH_GRID" $BENCH_FLAGS \
+        "${BENCH_SRC[@]}" -o visualizer/rrrlz-bench-pgo -lm -Wl,--emit-relocs
+    echo "  -> visualizer/rrrlz-bench-pgo"
+
+    bench_compare visualizer/rrrlz-bench-pgo
+}
+
+# rrrlz-bench-pgo rewritten by llvm-bolt from a profile of itself running
+# BOLT_TRAIN: hot blocks laid out as fall-throughs (ext-tsp), hot functions
+# packed together (hfsort) and cold blocks split out, then front-end misses
+# and run time compared with the PGO build it came from
+build_bench_bolt() {
+    echo ""
+    echo "============================================"
+    echo "  Building: rrrlz-bench-bolt (llvm-bolt)"
+    echo "============================================"
+    local pgo=visualizer/rrrlz-bench-pgo
+    local fdata=visualizer/rrrlz-bench.fdata
+    local mode="$BOLT_PROFILE"
+    if [ "$mode" = auto ]; then
+        mode=instrument
+        if command -v perf > /dev/null &&
+           perf record -e cycles:u -j any,u -o /dev/null -- true > /dev/null 2>&1; then
+            mode=lbr
+        fi
+    fi
+
+    rm -f "$fdata"
+    case "$mode" in
+        lbr)
+            perf record -e cycles:u -j any,u -o visualizer/rrrlz-bench.perf.data \
+                -- "./$pgo" $BOLT_TRAIN > /dev/null 2>&1
+            perf2bolt -p visualizer/rrrlz-bench.perf.data -o "$fdata" "$pgo" > /dev/null
+            rm -f visualizer/rrrlz-bench.perf.data
+            ;;
+        instrument)
+            llvm-bolt "$pgo" -instrument -instrumentation-file="$PWD/$fdata" \
+                -o visualizer/rrrlz-bench-bolt-inst > /dev/null
+            ./visualizer/rrrlz-bench-bolt-inst $BOLT_TRAIN > /dev/null
+            ;;
+        *)
+            echo "Unknown BOLT_PROFILE: $mode (lbr, instrument or auto)"
+            exit 1
+            ;;
+    esac
+    echo "  -> $fdata ($mode profile of: $BOLT_TRAIN)"
+
+    llvm-bolt "$pgo" -data="$fdata" -o visualizer/rrrlz-bench-bolt \
+        -reorder-blocks=ext-tsp -reorder-functions=hfsort \
+        -split-functions -split-all-cold -dyno-stats > visualizer/rrrlz-bench-bolt.log
+    echo "  -> visualizer/rrrlz-bench-bolt (llvm-bolt log: visualizer/rrrlz-bench-bolt.log)"
+
+    echo ""
+    printf "  %-20s %10s %14s %14s %14s\n" "Binary" "Bytes" "Instructions" "L1-I misses" "iTLB misses"
+    printf "  %-20s %10s %14s %14s %14s\n" "------" "-----" "------------" "-----------" "-----------"
+    local bin
+    for bin in "$pgo" visualizer/rrrlz-bench-bolt; do
+        printf "  %-20s %10s %14s %14s %14s\n" "$(basename "$bin")" "$(wc -c < "$bin")" \
+            "$(instructions "./$bin" $BENCH_COMPARE)" \
+            "$(perf_count L1-icache-load-misses:u "./$bin" $BENCH_COMPARE)" \
+            "$(perf_count iTLB-load-misses:u "./$bin" $BENCH_COMPARE)"
+    done
+
+    bench_compare visualizer/rrrlz-bench-bolt "$pgo"
+}
+
+# rrrlz-bench linked with full LTO and with ThinLTO (through lld), next to
+# a plain -O2 build: build time and size of each, then each LTO build
+# timed against the plain one. The plugins are still called through
+# AlgoPlugin pointers, so LTO does not inline step() into the driver.
+build_bench_lto() {
+    echo ""
+    echo "============================================"
+    echo "  Building: rrrlz-bench-lto, rrrlz-bench-thinlto"
+    echo "============================================"
+    local names=(rrrlz-bench rrrlz-bench-lto rrrlz-bench-thinlto)
+    local flags=("" "-flto=full -fuse-ld=lld" "-flto=thin -fuse-ld=lld")
+    local build_ms=()
+    for i in 0 1 2; do
+        local t0=$(date +%s%N)
+        clang -O2 ${flags[$i]} -DMAX_ROWS="$BENCH_GRID" -DMAX_COLS="$BENCH_GRID" $BENCH_FLAGS \
+            "${BENCH_SRC[@]}" -o "visualizer/${names[$i]}" -lm
+        local t1=$(date +%s%N)
+        build_ms+=($(( (t1 - t0) / 1000000 )))
+        echo "  -> visualizer/${names[$i]}"
+    done
+    BENCH_BUILT=1
+
+    echo ""
+    printf "  %-22s %-28s %10s %10s\n" "Binary" "Flags" "Build ms" "Bytes"
+    printf "  %-22s %-28s %10s %10s\n" "------" "-----" "--------" "-----"
+    for i in 0 1 2; do
+        printf "  %-22s %-28s %10s %10s\n" "${names[$i]}" "-O2 ${flags[$i]}" \
+            "${build_ms[$i]}" "$(wc -c < "visualizer/${names[$i]}")"
+    done
+
+    bench_compare visualizer/rrrlz-bench-lto
+    bench_compare visualizer/rrrlz-bench-thinlto
+}
+
 # Determine what to build
 TARGETS=()
 BUILD_VIS=0
+BUILD_BENCH=0
+BUILD_TERM=0
+BUILD_BENCH_PGO=0
+BUILD_BENCH_LTO=0
+BUILD_BENCH_BOLT=0
 if [ $# -eq 0 ]; then
     TARGETS=("hello/hello.c" "dijkstra/dijkstra.c" "astar/astar.c" "bellman_ford/bellman_ford.c" "floyd_warshall/floyd_warshall.c" "ida_star/ida_star.c")
     BUILD_VIS=1
+    BUILD_BENCH=1
+    BUILD_TERM=1
 else
     for arg in "$@"; do
         case "$arg" in
@@ -81,6 +412,11 @@ else
             floyd_warshall) TARGETS+=("floyd_warshall/floyd_warshall.c") ;;
             ida_star)   TARGETS+=("ida_star/ida_star.c") ;;
             visualizer) BUILD_VIS=1 ;;
+            bench)      BUILD_BENCH=1 ;;
+            term)       BUILD_TERM=1 ;;
+            bench-pgo)  BUILD_BENCH_PGO=1 ;;
+            bench-lto)  BUILD_BENCH_LTO=1 ;;
+            bench-bolt) BUILD_BENCH_PGO=1; BUILD_BENCH_BOLT=1 ;;
             *)          TARGETS+=("$arg") ;;
         esac
     done
@@ -99,6 +435,27 @@ elif [ "$BUILD_VIS" -eq 1 ]; then
     echo "⚠ Skipping visualizer: SDL2 not found (apt install libsdl2-dev)"
 fi
 
+# Build headless benchmark (no SDL needed)
+if [ "$BUILD_BENCH" -eq 1 ]; then
+    build_bench
+fi
+
+# Build terminal front-end (no SDL needed)
+if [ "$BUILD_TERM" -eq 1 ]; then
+    build_term
+fi
+
+# Profile-guided and LTO benchmark builds and comparisons (opt-in)
+if [ "$BUILD_BENCH_PGO" -eq 1 ]; then
+    build_bench_pgo
+fi
+if [ "$BUILD_BENCH_LTO" -eq 1 ]; then
+    build_bench_lto
+fi
+if [ "$BUILD_BENCH_BOLT" -eq 1 ]; then
+    build_bench_bolt
+fi
+
 # Size comparison table
 echo ""
 echo ""
@@ -124,6 +481,41 @@ for target in "${TARGETS[@]}"; do
     done
 done
 
+# Runtime table: which optimization levels pay off, relative to clang -O0
+if [ "$RUNS" -gt 0 ] && [ ${#TARGETS[@]} -gt 0 ]; then
+    echo ""
+    echo ""
+    echo "╔══════════════════════════════════════════════════╗"
+    echo "║           RUNTIME TABLE                          ║"
+    echo "╚══════════════════════════════════════════════════╝"
+
+    for target in "${TARGETS[@]}"; do
+        dir="$(dirname "$target")"
+        base="$(basename "$target" .c)"
+        prefix="${dir}/${base}"
+
+        bins=(clang_O0 clang_O1 clang_O2 clang_O3 clang_Os clang_Oz
+              opt_O1 opt_O2 opt_O3 opt_Os opt_Oz)
+        [ "$PGO" -eq 1 ] && bins+=("pgo_${PGO_OPT}")
+
+        args=$(run_args "$base")
+
+        echo ""
+        echo "--- ${target}${args:+ $args} (median of ${RUNS} runs) ---"
+        echo ""
+        printf "  %-10s %12s %16s %9s\n" "Binary" "Median us" "Instructions" "vs O0"
+        printf "  %-10s %12s %16s %9s\n" "------" "---------" "------------" "-----"
+        base_us=""
+        for bin in "${bins[@]}"; do
+            t=$(median_us "./${prefix}_${bin}" $args)
+            insns=$(instructions "./${prefix}_${bin}" $args)
+            [ -z "$base_us" ] && base_us=$t
+            speedup=$(awk -v b="$base_us" -v t="$t" 'BEGIN { printf "%.2fx", (t > 0 ? b / t : 0) }')
+            printf "  %-10s %12s %16s %9s\n" "$bin" "$t" "$insns" "$speedup"
+        done
+    done
+fi
+
 echo ""
 echo "=== Done. ==="
 echo "Compare IR:       diff dijkstra/dijkstra_opt_O1.ll dijkstra/dijkstra_opt_O3.ll"
@@ -1,13 +1,32 @@
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 #include <limits.h>
 
+/*
+ * Map size. By default ROWS and COLS are read at run time: the built-in
+ * 20x20 map, or a generated one with --size WxH [--seed N], searched
+ * --reps times, so the pipeline can time each optimization level on maps
+ * bigger than the caches. Built with -DFIXED_GRID this is the original
+ * program, where ROWS, COLS and every array bound are compile-time
+ * constants the optimizer can fold; only --reps is accepted.
+ */
+#ifdef FIXED_GRID
 #define ROWS 20
 #define COLS 20
+#else
+static int rows = 20, cols = 20;
+#define ROWS rows
+#define COLS cols
+#endif
 #define MAX_NODES (ROWS * COLS)
 #define INF (MAX_NODES + 1)
+#define MAX_SIDE  8192   /* --size limit, keeps node counts in an int */
+#define WALL_PCT  20     /* generated maps: chance of a wall per cell */
+#define PRINT_MAX 64     /* larger maps are not drawn */
 
 /* 0 = open, 1 = wall */
-static const int grid[ROWS][COLS] = {
+static const int grid20[20][20] = {
     {0,0,0,0,0,1,0,0,0,0,0,0,0,0,1,0,0,0,0,0},
     {0,1,1,0,0,1,0,1,1,0,1,1,0,0,1,0,1,1,0,0},
     {0,1,0,0,0,0,0,0,1,0,0,1,0,0,0,0,0,1,0,0},
@@ -30,8 +49,16 @@ static const int grid[ROWS][COLS] = {
     {0,0,1,0,0,0,1,0,0,0,0,1,0,0,0,0,0,0,0,0},
 };
 
+#ifdef FIXED_GRID
+#define CELL(r, c) grid20[r][c]
+#else
+static unsigned char *grid;   /* ROWS x COLS, row-major */
+#define CELL(r, c) grid[(r) * COLS + (c)]
+#endif
+
 static const int START_R = 0, START_C = 0;
-static const int END_R = 19, END_C = 19;
+#define END_R (ROWS - 1)
+#define END_C (COLS - 1)
 
 /* Direction offsets: up, down, left, right */
 static const int DR[4] = {-1, 1, 0, 0};
@@ -42,25 +69,109 @@ static inline int get_index(int r, int c) {
 }
 
 static inline int is_valid(int r, int c) {
-    return r >= 0 && r < ROWS && c >= 0 && c < COLS && grid[r][c] == 0;
+    return r >= 0 && r < ROWS && c >= 0 && c < COLS && CELL(r, c) == 0;
 }
 
-/* 400x400 matrices — 640KB each, declared static to avoid stack overflow */
+/* MAX_NODES x MAX_NODES matrices. Fixed build: 400x400, 640KB each,
+ * declared static to avoid stack overflow. Otherwise sized by setup(); a
+ * 32x32 map already needs 4MB each. */
+#ifdef FIXED_GRID
 static int dist[MAX_NODES][MAX_NODES];
 static int next[MAX_NODES][MAX_NODES];
+#define DIST(i, j) dist[i][j]
+#define NEXT(i, j) next[i][j]
+#else
+static int *dist, *next;
+#define DIST(i, j) dist[(size_t)(i) * MAX_NODES + (j)]
+#define NEXT(i, j) next[(size_t)(i) * MAX_NODES + (j)]
+#endif
+static int reps = 1;
+
+static void usage(const char *prog) {
+#ifdef FIXED_GRID
+    fprintf(stderr, "Usage: %s [--reps N]\n", prog);
+#else
+    fprintf(stderr, "Usage: %s [--size WxH] [--seed N] [--reps N]\n", prog);
+#endif
+    exit(1);
+}
+
+#ifndef FIXED_GRID
+/* splitmix64, so a seed gives the same map on every build and libc */
+static unsigned long long next_random(unsigned long long *state) {
+    unsigned long long z = (*state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+#endif
+
+/* Parse the arguments; without FIXED_GRID also build the map (the
+ * built-in one unless --size or --seed is given) and size the arrays */
+static void setup(int argc, char *argv[]) {
+#ifndef FIXED_GRID
+    int generate = 0;
+    unsigned long long seed = 1;
+#endif
+    for (int a = 1; a < argc; a++) {
+        if (strcmp(argv[a], "--reps") == 0 && a + 1 < argc) {
+            reps = atoi(argv[++a]);
+#ifndef FIXED_GRID
+        } else if (strcmp(argv[a], "--size") == 0 && a + 1 < argc) {
+            const char *size = argv[++a];
+            if (sscanf(size, "%dx%d", &cols, &rows) != 2)
+                rows = cols = atoi(size);
+            generate = 1;
+        } else if (strcmp(argv[a], "--seed") == 0 && a + 1 < argc) {
+            seed = strtoull(argv[++a], NULL, 0);
+            generate = 1;
+#endif
+        } else {
+            usage(argv[0]);
+        }
+    }
+    if (reps < 1)
+        usage(argv[0]);
+
+#ifndef FIXED_GRID
+    if (rows < 3 || cols < 3 || rows > MAX_SIDE || cols > MAX_SIDE)
+        usage(argv[0]);
+    size_t n = (size_t)MAX_NODES;
+    grid = malloc(n);
+    dist = malloc(n * n * sizeof(*dist));
+    next = malloc(n * n * sizeof(*next));
+    if (!grid || !dist || !next) {
+        fprintf(stderr, "out of memory for a %dx%d map\n", COLS, ROWS);
+        exit(1);
+    }
+    for (int r = 0; r < ROWS; r++)
+        for (int c = 0; c < COLS; c++)
+            CELL(r, c) = generate ? next_random(&seed) % 100 < WALL_PCT : grid20[r][c];
+
+    /* Clear the corners of a generated map, so start and end are almost
+     * never walled in */
+    for (int r = 0; generate && r < 3; r++) {
+        for (int c = 0; c < 3; c++) {
+            CELL(START_R + r, START_C + c) = 0;
+            CELL(END_R - r, END_C - c) = 0;
+        }
+    }
+#endif
+}
 
-int main(void) {
+/* All-pairs shortest paths over the open cells */
+static void search(void) {
     int V = MAX_NODES;
 
     /* Initialize dist and next matrices */
     for (int i = 0; i < V; i++) {
         for (int j = 0; j < V; j++) {
             if (i == j) {
-                dist[i][j] = 0;
-                next[i][j] = i;
+                DIST(i, j) = 0;
+                NEXT(i, j) = i;
             } else {
-                dist[i][j] = INF;
-                next[i][j] = -1;
+                DIST(i, j) = INF;
+                NEXT(i, j) = -1;
             }
         }
     }
@@ -68,15 +179,15 @@ int main(void) {
     /* Build adjacency: edge weight 1 between adjacent open cells */
     for (int r = 0; r < ROWS; r++) {
         for (int c = 0; c < COLS; c++) {
-            if (grid[r][c] == 1) continue; /* skip walls */
+            if (CELL(r, c) == 1) continue; /* skip walls */
             int u = get_index(r, c);
             for (int d = 0; d < 4; d++) {
                 int nr = r + DR[d];
                 int nc = c + DC[d];
                 if (!is_valid(nr, nc)) continue;
                 int v = get_index(nr, nc);
-                dist[u][v] = 1;
-                next[u][v] = v;
+                DIST(u, v) = 1;
+                NEXT(u, v) = v;
             }
         }
     }
@@ -86,65 +197,75 @@ int main(void) {
         /* Skip wall nodes as intermediates — they have no edges */
         int kr = k / COLS;
         int kc = k % COLS;
-        if (grid[kr][kc] == 1) continue;
+        if (CELL(kr, kc) == 1) continue;
 
         for (int i = 0; i < V; i++) {
-            if (dist[i][k] == INF) continue; /* prune: no path i->k */
+            if (DIST(i, k) == INF) continue; /* prune: no path i->k */
             for (int j = 0; j < V; j++) {
-                if (dist[k][j] == INF) continue; /* prune: no path k->j */
-                int through_k = dist[i][k] + dist[k][j];
-                if (through_k < dist[i][j]) {
-                    dist[i][j] = through_k;
-                    next[i][j] = next[i][k];
+                if (DIST(k, j) == INF) continue; /* prune: no path k->j */
+                int through_k = DIST(i, k) + DIST(k, j);
+                if (through_k < DIST(i, j)) {
+                    DIST(i, j) = through_k;
+                    NEXT(i, j) = NEXT(i, k);
                 }
             }
         }
     }
+}
+
+int main(int argc, char *argv[]) {
+    setup(argc, argv);
+
+    for (int rep = 0; rep < reps; rep++)
+        search();
 
     int start = get_index(START_R, START_C);
     int end = get_index(END_R, END_C);
 
-    /* Reconstruct path from start to end */
-    char path_grid[ROWS][COLS];
-    for (int r = 0; r < ROWS; r++)
-        for (int c = 0; c < COLS; c++)
-            path_grid[r][c] = grid[r][c] ? '#' : '.';
-
     int path_len = 0;
-    if (dist[start][end] != INF) {
-        int cur = start;
-        while (cur != end) {
-            int r = cur / COLS;
-            int c = cur % COLS;
-            path_grid[r][c] = '*';
-            cur = next[cur][end];
+    if (DIST(start, end) != INF) {
+        for (int cur = start; cur != end; cur = NEXT(cur, end))
             path_len++;
-        }
-        /* Mark the end node */
+        /* Count the end node */
         path_len++;
     }
 
-    path_grid[START_R][START_C] = 'S';
-    path_grid[END_R][END_C] = 'E';
-
     /* Count open vertices */
     int total_vertices = 0;
     for (int r = 0; r < ROWS; r++)
         for (int c = 0; c < COLS; c++)
-            if (grid[r][c] == 0) total_vertices++;
+            if (CELL(r, c) == 0) total_vertices++;
 
-    /* Print grid */
-    printf("Floyd-Warshall Pathfinding (%dx%d grid)\n", ROWS, COLS);
+    printf("Floyd-Warshall Pathfinding (%dx%d grid)\n", COLS, ROWS);
     printf("------------------------------------------\n");
-    for (int r = 0; r < ROWS; r++) {
-        for (int c = 0; c < COLS; c++)
-            putchar(path_grid[r][c]);
-        putchar('\n');
+    if (ROWS <= PRINT_MAX && COLS <= PRINT_MAX) {
+        /* Reconstruct path from start to end */
+        char path_grid[ROWS][COLS];
+        for (int r = 0; r < ROWS; r++)
+            for (int c = 0; c < COLS; c++)
+                path_grid[r][c] = CELL(r, c) ? '#' : '.';
+
+        if (DIST(start, end) != INF) {
+            for (int cur = start; cur != end; cur = NEXT(cur, end))
+                path_grid[cur / COLS][cur % COLS] = '*';
+        }
+
+        path_grid[START_R][START_C] = 'S';
+        path_grid[END_R][END_C] = 'E';
+
+        /* Print grid */
+        for (int r = 0; r < ROWS; r++) {
+            for (int c = 0; c < COLS; c++)
+                putchar(path_grid[r][c]);
+            putchar('\n');
+        }
+        printf("------------------------------------------\n");
     }
-    printf("------------------------------------------\n");
-    printf("Path cost:      %d\n", dist[start][end] != INF ? dist[start][end] : -1);
+    printf("Path cost:      %d\n", DIST(start, end) != INF ? DIST(start, end) : -1);
     printf("Path length:    %d nodes\n", path_len);
     printf("Total vertices: %d\n", total_vertices);
+    if (reps > 1)
+        printf("Reps:           %d\n", reps);
 
     return 0;
 }
@@ -10,13 +10,23 @@
 
 #include <limits.h>
 #include <math.h>
+#include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
+#include <time.h>
+
+#include "trace.h"
 
 /* ── Grid upper bounds ───────────────────────────────────────────── */
 
+/* Override at build time for large maps, e.g. -DMAX_ROWS=1024 -DMAX_COLS=1024.
+ * Only the product matters: any map with rows * cols <= MAX_NODES fits. */
+#ifndef MAX_ROWS
 #define MAX_ROWS 100
+#endif
+#ifndef MAX_COLS
 #define MAX_COLS 100
+#endif
 #define MAX_NODES (MAX_ROWS * MAX_COLS)
 
 static const int DR[4] = {-1, 1, 0, 0};
@@ -33,6 +43,7 @@ typedef struct {
     int rows, cols;
     int start_r, start_c, end_r, end_c;
     const int *data;  /* flat row-major array */
+    const int *cost;  /* optional per-cell move cost, NULL = uniform */
 } MapDef;
 
 /* ── Cell visualization enum ─────────────────────────────────────── */
@@ -48,10 +59,43 @@ enum CellVis {
     VIS_PREPROCESS, /* preprocessing phases (RSR, Subgoal, CH) */
 };
 
+/* ── Search phases ───────────────────────────────────────────────── */
+
+/* Plugins with a preprocessing stage (RSR, Subgoal, CH, Floyd-Warshall,
+ * Flow Field) switch phases with vis_set_phase() so preprocessing can be
+ * amortized separately from per-query cost. Everything else runs as a
+ * single PHASE_QUERY followed by PHASE_UNPACK in vis_trace_path(). */
+enum AlgoPhase {
+    PHASE_PREPROCESS,   /* graph abstraction / contraction / all-pairs */
+    PHASE_EDGES,        /* building edges of the abstract graph */
+    PHASE_QUERY,        /* start-to-goal search */
+    PHASE_UNPACK,       /* path reconstruction */
+    PHASE_COUNT,
+    PHASE_DONE = PHASE_COUNT,
+};
+
+static const char *const phase_names[PHASE_COUNT] = {
+    "preprocess", "edges", "query", "unpack",
+};
+
+typedef struct {
+    int    steps;
+    int    nodes_explored;
+    int    relaxations;
+    double us;          /* wall time spent in the phase */
+} PhaseStats;
+
 /* ── Visualization state (first member of every algo state struct) ─ */
 
+/* Plugins change cells only through vis_set_cell(), which also appends the
+ * index to a change list. Consumers (the visualizer, recordings) apply the
+ * list and call vis_clear_dirty(), so their work follows search activity
+ * rather than grid size. Past VIS_DIRTY_CAP changes the list stops growing
+ * and dirty_all asks for a full rescan instead. */
+#define VIS_DIRTY_CAP 4096
+
 typedef struct {
-    int cells[MAX_NODES];
+    uint8_t cells[MAX_NODES];       /* enum CellVis */
     int done;
     int found;
     int nodes_explored;
@@ -61,6 +105,13 @@ typedef struct {
     int relaxations;
     int rows, cols;
     int start_node, end_node;
+    int phase;                      /* enum AlgoPhase */
+    PhaseStats phases[PHASE_COUNT];
+    double phase_t0;                /* internal: phase start, counter marks */
+    int phase_steps0, phase_nodes0, phase_relax0;
+    int dirty_all;                  /* change list overflowed: rescan cells */
+    int dirty_count;
+    int dirty[VIS_DIRTY_CAP];       /* cells changed since vis_clear_dirty() */
 } AlgoVis;
 
 /* ── Plugin descriptor ───────────────────────────────────────────── */
@@ -70,6 +121,8 @@ typedef struct {
     AlgoVis *(*init)(const MapDef *map);
     int      (*step)(AlgoVis *vis);
     int      max_nodes;  /* 0=unlimited, >0=skip if map has more nodes */
+    int      any_angle;  /* 1=path_cost is euclidean x100, not grid steps */
+    size_t   state_bytes; /* static or heap state reserved per instance */
 } AlgoPlugin;
 
 /* ── Inline helpers ──────────────────────────────────────────────── */
@@ -106,6 +159,7 @@ static inline int line_of_sight(const MapDef *map, int r1, int c1, int r2, int c
         if (cr != r1 || cc != c1) {
             if (cr < 0 || cr >= map->rows || cc < 0 || cc >= map->cols)
                 return 0;
+            HEAT_COUNT(HEAT_LOS, cr * map->cols + cc);
             if (map->data[cr * map->cols + cc] != 0)
                 return 0;
         }
@@ -121,7 +175,47 @@ static inline int is_passable(const int *data, int cols, int r, int c, int rows)
     return r >= 0 && r < rows && c >= 0 && c < cols && data[r * cols + c] == 0;
 }
 
-/* Helper: initialize cells array from map */
+static inline double vis_clock_us(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e6 + ts.tv_nsec / 1e3;
+}
+
+/* Close the current phase (crediting its time and counters) and enter
+ * `phase`. Only called at transitions, so it costs a few clock reads per
+ * search; PHASE_DONE closes the last phase. */
+static inline void vis_set_phase(AlgoVis *vis, int phase) {
+    double now = vis_clock_us();
+    if (vis->phase < PHASE_COUNT) {
+        PhaseStats *p = &vis->phases[vis->phase];
+        p->us += now - vis->phase_t0;
+        p->steps += vis->steps - vis->phase_steps0;
+        p->nodes_explored += vis->nodes_explored - vis->phase_nodes0;
+        p->relaxations += vis->relaxations - vis->phase_relax0;
+    }
+    vis->phase = phase;
+    TRACE_PHASE(phase);
+    vis->phase_t0 = now;
+    vis->phase_steps0 = vis->steps;
+    vis->phase_nodes0 = vis->nodes_explored;
+    vis->phase_relax0 = vis->relaxations;
+}
+
+static inline void vis_set_cell(AlgoVis *vis, int idx, int state) {
+    if (vis->cells[idx] == state) return;
+    vis->cells[idx] = (uint8_t)state;
+    if (vis->dirty_count < VIS_DIRTY_CAP)
+        vis->dirty[vis->dirty_count++] = idx;
+    else
+        vis->dirty_all = 1;
+}
+
+static inline void vis_clear_dirty(AlgoVis *vis) {
+    vis->dirty_count = 0;
+    vis->dirty_all = 0;
+}
+
+/* Helper: initialize cells array from map (marks everything dirty) */
 static inline void vis_init_cells(AlgoVis *vis, const MapDef *map) {
     int total = map->rows * map->cols;
     vis->rows = map->rows;
@@ -131,11 +225,11 @@ static inline void vis_init_cells(AlgoVis *vis, const MapDef *map) {
 
     for (int i = 0; i < total; i++)
         vis->cells[i] = map->data[i] ? VIS_WALL : VIS_EMPTY;
-    for (int i = total; i < MAX_NODES; i++)
-        vis->cells[i] = VIS_EMPTY;
 
     vis->cells[vis->start_node] = VIS_START;
     vis->cells[vis->end_node] = VIS_END;
+    vis->dirty_count = 0;
+    vis->dirty_all = 1;
     vis->done = 0;
     vis->found = 0;
     vis->nodes_explored = 0;
@@ -143,19 +237,24 @@ static inline void vis_init_cells(AlgoVis *vis, const MapDef *map) {
     vis->path_len = 0;
     vis->path_cost = 0;
     vis->relaxations = 0;
+    memset(vis->phases, 0, sizeof(vis->phases));
+    vis->phase = PHASE_DONE;
+    vis_set_phase(vis, PHASE_QUERY);
 }
 
 /* Helper: trace path from end to start using parent array */
 static inline void vis_trace_path(AlgoVis *vis, const int *parent, const int *cost) {
+    vis_set_phase(vis, PHASE_UNPACK);
     int end = vis->end_node;
     vis->path_cost = cost[end];
     int cur = end;
     while (cur != -1) {
         if (cur != vis->start_node && cur != vis->end_node)
-            vis->cells[cur] = VIS_PATH;
+            vis_set_cell(vis, cur, VIS_PATH);
         vis->path_len++;
         cur = parent[cur];
     }
+    vis_set_phase(vis, PHASE_DONE);
 }
 
 /* ── Min-heap ────────────────────────────────────────────────────── */
@@ -170,9 +269,13 @@ typedef struct {
 typedef struct {
     HeapEntry data[HEAP_CAP];
     int size;
+    const int *node_cell;   /* heap node -> cell for heat counts; NULL = same */
 } Heap;
 
-static inline void heap_init(Heap *h) { h->size = 0; }
+static inline void heap_init(Heap *h) {
+    h->size = 0;
+    h->node_cell = NULL;
+}
 
 static inline void heap_push(Heap *h, int node, int priority) {
     if (h->size >= HEAP_CAP) return;
@@ -187,6 +290,8 @@ static inline void heap_push(Heap *h, int node, int priority) {
         h->data[p] = tmp;
         i = p;
     }
+    TRACE_HEAP_PUSH(node, priority, h->size);
+    HEAT_COUNT(HEAT_PUSH, h->node_cell ? h->node_cell[node] : node);
 }
 
 static inline HeapEntry heap_pop(Heap *h) {
@@ -203,6 +308,7 @@ static inline HeapEntry heap_pop(Heap *h) {
         h->data[s] = tmp;
         i = s;
     }
+    TRACE_HEAP_POP(top.node, top.priority, h->size);
     return top;
 }
 
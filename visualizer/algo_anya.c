@@ -22,8 +22,8 @@ typedef struct {
 static BiAstarState *state;
 
 static AlgoVis *bidir_init(const MapDef *map) {
-    free(state);
-    state = calloc(1, sizeof(*state));
+    /* Allocated once; reset only the map-sized prefix of each array */
+    if (!state) state = calloc(1, sizeof(*state));
     state->map = map;
     vis_init_cells(&state->vis, map);
     heap_init(&state->fwd_heap);
@@ -35,6 +35,8 @@ static AlgoVis *bidir_init(const MapDef *map) {
         state->bwd_cost[i] = INT_MAX;
         state->fwd_parent[i] = -1;
         state->bwd_parent[i] = -1;
+        state->fwd_closed[i] = 0;
+        state->bwd_closed[i] = 0;
     }
 
     int start = state->vis.start_node;
@@ -88,9 +90,10 @@ static int bidir_step(AlgoVis *vis) {
         if (s->fwd_closed[node]) return 1;
         s->fwd_closed[node] = 1;
         s->vis.nodes_explored++;
+        TRACE_EXPAND(node);
 
         if (node != s->vis.start_node && node != s->vis.end_node)
-            s->vis.cells[node] = VIS_OPEN;  /* forward frontier color */
+            vis_set_cell(&s->vis, node, VIS_OPEN);  /* forward frontier color */
 
         /* Check if backward search has reached this node */
         if (s->bwd_cost[node] != INT_MAX) {
@@ -111,6 +114,7 @@ static int bidir_step(AlgoVis *vis) {
             int new_g = s->fwd_cost[node] + 1;
             if (new_g < s->fwd_cost[neighbor]) {
                 s->vis.relaxations++;
+                TRACE_RELAX(neighbor, new_g);
                 s->fwd_cost[neighbor] = new_g;
                 s->fwd_parent[neighbor] = node;
                 int h = manhattan(nr, nc, s->map->end_r, s->map->end_c);
@@ -126,9 +130,10 @@ static int bidir_step(AlgoVis *vis) {
         if (s->bwd_closed[node]) return 1;
         s->bwd_closed[node] = 1;
         s->vis.nodes_explored++;
+        TRACE_EXPAND(node);
 
         if (node != s->vis.start_node && node != s->vis.end_node)
-            s->vis.cells[node] = VIS_CLOSED;  /* backward frontier color */
+            vis_set_cell(&s->vis, node, VIS_CLOSED);  /* backward frontier color */
 
         if (s->fwd_cost[node] != INT_MAX) {
             int total_cost = s->fwd_cost[node] + s->bwd_cost[node];
@@ -148,6 +153,7 @@ static int bidir_step(AlgoVis *vis) {
             int new_g = s->bwd_cost[node] + 1;
             if (new_g < s->bwd_cost[neighbor]) {
                 s->vis.relaxations++;
+                TRACE_RELAX(neighbor, new_g);
                 s->bwd_cost[neighbor] = new_g;
                 s->bwd_parent[neighbor] = node;
                 int h = manhattan(nr, nc, s->map->start_r, s->map->start_c);
@@ -164,12 +170,13 @@ found:
     s->vis.done = 1;
     s->vis.found = 1;
     s->vis.path_cost = s->mu;
+    vis_set_phase(&s->vis, PHASE_UNPACK);
     /* Trace forward path: meet_node → start */
     {
         int cur = s->meet_node;
         while (cur != -1) {
             if (cur != s->vis.start_node && cur != s->vis.end_node)
-                s->vis.cells[cur] = VIS_PATH;
+                vis_set_cell(&s->vis, cur, VIS_PATH);
             s->vis.path_len++;
             cur = s->fwd_parent[cur];
         }
@@ -179,11 +186,12 @@ found:
         int cur = s->bwd_parent[s->meet_node];
         while (cur != -1) {
             if (cur != s->vis.start_node && cur != s->vis.end_node)
-                s->vis.cells[cur] = VIS_PATH;
+                vis_set_cell(&s->vis, cur, VIS_PATH);
             s->vis.path_len++;
             cur = s->bwd_parent[cur];
         }
     }
+    vis_set_phase(&s->vis, PHASE_DONE);
     return 0;
 }
 
@@ -191,4 +199,5 @@ AlgoPlugin algo_anya = {
     .name = "BiDir-A*",
     .init = bidir_init,
     .step = bidir_step,
+    .state_bytes = sizeof(BiAstarState),
 };
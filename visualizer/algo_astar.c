@@ -16,7 +16,7 @@ typedef struct {
 static AstarState state;
 
 static AlgoVis *astar_init(const MapDef *map) {
-    memset(&state, 0, sizeof(state));
+    /* Reset only the map-sized prefix of each array (not all of MAX_NODES) */
     state.map = map;
     vis_init_cells(&state.vis, map);
     heap_init(&state.heap);
@@ -25,6 +25,7 @@ static AlgoVis *astar_init(const MapDef *map) {
     for (int i = 0; i < total; i++) {
         state.cost[i] = INT_MAX;
         state.parent[i] = -1;
+        state.closed[i] = 0;
     }
 
     int start = state.vis.start_node;
@@ -50,9 +51,10 @@ static int astar_step(AlgoVis *vis) {
 
     s->closed[node] = 1;
     s->vis.nodes_explored++;
+    TRACE_EXPAND(node);
 
     if (node != s->vis.start_node && node != s->vis.end_node)
-        s->vis.cells[node] = VIS_CLOSED;
+        vis_set_cell(&s->vis, node, VIS_CLOSED);
 
     if (node == s->vis.end_node) {
         s->vis.done = 1;
@@ -70,6 +72,7 @@ static int astar_step(AlgoVis *vis) {
         int new_g = s->cost[node] + 1;
         if (new_g < s->cost[neighbor]) {
             s->vis.relaxations++;
+            TRACE_RELAX(neighbor, new_g);
             s->cost[neighbor] = new_g;
             s->parent[neighbor] = node;
             heap_push(&s->heap, neighbor,
@@ -77,7 +80,7 @@ static int astar_step(AlgoVis *vis) {
 
             if (neighbor != s->vis.start_node &&
                 neighbor != s->vis.end_node)
-                s->vis.cells[neighbor] = VIS_OPEN;
+                vis_set_cell(&s->vis, neighbor, VIS_OPEN);
         }
     }
 
@@ -88,4 +91,5 @@ AlgoPlugin algo_astar = {
     .name = "A*",
     .init = astar_init,
     .step = astar_step,
+    .state_bytes = sizeof(AstarState),
 };
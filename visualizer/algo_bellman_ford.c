@@ -31,7 +31,7 @@ typedef struct {
 static BellmanFordState state;
 
 static AlgoVis *bellman_ford_init(const MapDef *map) {
-    memset(&state, 0, sizeof(state));
+    /* Reset only the map-sized prefix of each array (not all of MAX_NODES) */
     state.map = map;
     vis_init_cells(&state.vis, map);
     state.total_nodes = map->rows * map->cols;
@@ -39,9 +39,11 @@ static AlgoVis *bellman_ford_init(const MapDef *map) {
     for (int i = 0; i < state.total_nodes; i++) {
         state.cost[i] = INT_MAX;
         state.parent[i] = -1;
+        state.reached[i] = 0;
     }
 
     /* Build edge list */
+    vis_set_phase(&state.vis, PHASE_EDGES);
     int cols = map->cols;
     state.edge_count = 0;
     for (int r = 0; r < map->rows; r++) {
@@ -65,6 +67,7 @@ static AlgoVis *bellman_ford_init(const MapDef *map) {
     state.bf_iter = 0;
     state.bf_changed = 0;
 
+    vis_set_phase(&state.vis, PHASE_QUERY);
     return &state.vis;
 }
 
@@ -83,6 +86,7 @@ static int bellman_ford_step(AlgoVis *vis) {
         int new_cost = s->cost[e->from] + 1;
         if (new_cost < s->cost[e->to]) {
             s->vis.relaxations++;
+            TRACE_RELAX(e->to, new_cost);
             s->cost[e->to] = new_cost;
             s->parent[e->to] = e->from;
             s->bf_changed = 1;
@@ -90,12 +94,13 @@ static int bellman_ford_step(AlgoVis *vis) {
             if (!s->reached[e->to]) {
                 s->reached[e->to] = 1;
                 s->vis.nodes_explored++;
+                TRACE_EXPAND(e->to);
             }
 
             /* Color newly reached node */
             if (e->to != s->vis.start_node &&
                 e->to != s->vis.end_node)
-                s->vis.cells[e->to] = VIS_OPEN;
+                vis_set_cell(&s->vis, e->to, VIS_OPEN);
         }
     }
 
@@ -109,7 +114,7 @@ static int bellman_ford_step(AlgoVis *vis) {
             if (s->reached[i] &&
                 i != s->vis.start_node &&
                 i != s->vis.end_node)
-                s->vis.cells[i] = VIS_CLOSED;
+                vis_set_cell(&s->vis, i, VIS_CLOSED);
         }
 
         int end = s->vis.end_node;
@@ -127,4 +132,5 @@ AlgoPlugin algo_bellman_ford = {
     .name = "Bellman-Ford",
     .init = bellman_ford_init,
     .step = bellman_ford_step,
+    .state_bytes = sizeof(BellmanFordState),
 };
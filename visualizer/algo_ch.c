@@ -159,8 +159,8 @@ static void add_up_edge(CHState *s, int from, int to, int cost, int mid) {
 }
 
 static AlgoVis *ch_init(const MapDef *map) {
-    free(state);
-    state = calloc(1, sizeof(*state));
+    /* Allocated once; reset only the map-sized prefix of each array */
+    if (!state) state = calloc(1, sizeof(*state));
     state->map = map;
     vis_init_cells(&state->vis, map);
     heap_init(&state->fwd_heap);
@@ -172,11 +172,19 @@ static AlgoVis *ch_init(const MapDef *map) {
         state->bwd_dist[i] = INT_MAX;
         state->fwd_parent[i] = -1;
         state->bwd_parent[i] = -1;
+        state->fwd_closed[i] = 0;
+        state->bwd_closed[i] = 0;
+        state->level[i] = 0;
+        state->contracted[i] = 0;
+        state->up_count[i] = 0;
     }
+    state->shortcut_count = 0;
     state->mu = INT_MAX;
     state->meet_node = -1;
+    state->fwd_turn = 0;
     state->phase = 0;
     state->contract_order = 0;
+    vis_set_phase(&state->vis, PHASE_PREPROCESS);
 
     return &state->vis;
 }
@@ -206,7 +214,7 @@ static void ch_unpack_path(CHState *s, int from, int to) {
     }
     /* Direct edge — mark 'to' on path */
     if (to != s->vis.start_node && to != s->vis.end_node)
-        s->vis.cells[to] = VIS_PATH;
+        vis_set_cell(&s->vis, to, VIS_PATH);
     s->vis.path_len++;
 }
 
@@ -227,6 +235,7 @@ static int ch_step(AlgoVis *vis) {
             if (node < 0) {
                 /* All contracted, build upward graph and start search */
                 s->phase = 1;
+                vis_set_phase(&s->vis, PHASE_EDGES);
                 s->fwd_dist[s->vis.start_node] = 0;
                 s->bwd_dist[s->vis.end_node] = 0;
                 heap_push(&s->fwd_heap, s->vis.start_node, 0);
@@ -253,7 +262,7 @@ static int ch_step(AlgoVis *vis) {
             s->level[node] = s->contract_order++;
 
             if (node != s->vis.start_node && node != s->vis.end_node)
-                s->vis.cells[node] = VIS_PREPROCESS;
+                vis_set_cell(&s->vis, node, VIS_PREPROCESS);
 
             /* Add shortcuts */
             int r = node / cols, c = node % cols;
@@ -277,6 +286,7 @@ static int ch_step(AlgoVis *vis) {
             }
 
             s->vis.nodes_explored++;
+            TRACE_EXPAND(node);
         }
         return 1;
     }
@@ -293,6 +303,7 @@ static int ch_step(AlgoVis *vis) {
         }
         s->shortcut_count = 0; /* Processed */
         s->phase = 2;
+        vis_set_phase(&s->vis, PHASE_QUERY);
         return 1;
     }
 
@@ -306,8 +317,9 @@ static int ch_step(AlgoVis *vis) {
                 if (!s->fwd_closed[node]) {
                     s->fwd_closed[node] = 1;
                     s->vis.nodes_explored++;
+                    TRACE_EXPAND(node);
                     if (node != s->vis.start_node && node != s->vis.end_node)
-                        s->vis.cells[node] = VIS_OPEN;
+                        vis_set_cell(&s->vis, node, VIS_OPEN);
 
                     /* Check meeting */
                     if (s->bwd_dist[node] != INT_MAX) {
@@ -324,6 +336,7 @@ static int ch_step(AlgoVis *vis) {
                         int nc = s->fwd_dist[node] + s->up_cost[node][i];
                         if (nc < s->fwd_dist[nb]) {
                             s->vis.relaxations++;
+                            TRACE_RELAX(nb, nc);
                             s->fwd_dist[nb] = nc;
                             s->fwd_parent[nb] = node;
                             heap_push(&s->fwd_heap, nb, nc);
@@ -339,8 +352,9 @@ static int ch_step(AlgoVis *vis) {
                 if (!s->bwd_closed[node]) {
                     s->bwd_closed[node] = 1;
                     s->vis.nodes_explored++;
+                    TRACE_EXPAND(node);
                     if (node != s->vis.start_node && node != s->vis.end_node)
-                        s->vis.cells[node] = VIS_CLOSED;
+                        vis_set_cell(&s->vis, node, VIS_CLOSED);
 
                     if (s->fwd_dist[node] != INT_MAX) {
                         int total_cost = s->fwd_dist[node] + s->bwd_dist[node];
@@ -355,6 +369,7 @@ static int ch_step(AlgoVis *vis) {
                         int nc = s->bwd_dist[node] + s->up_cost[node][i];
                         if (nc < s->bwd_dist[nb]) {
                             s->vis.relaxations++;
+                            TRACE_RELAX(nb, nc);
                             s->bwd_dist[nb] = nc;
                             s->bwd_parent[nb] = node;
                             heap_push(&s->bwd_heap, nb, nc);
@@ -387,6 +402,7 @@ found_path:
         s->vis.done = 1;
         s->vis.found = 1;
         s->vis.path_cost = s->mu;
+        vis_set_phase(&s->vis, PHASE_UNPACK);
         /* Unpack path: forward from start to meet, backward from goal to meet */
         {
             /* Forward path */
@@ -404,6 +420,7 @@ found_path:
                 cur = s->bwd_parent[cur];
             }
         }
+        vis_set_phase(&s->vis, PHASE_DONE);
         return 0;
     }
 
@@ -414,4 +431,5 @@ AlgoPlugin algo_ch = {
     .name = "CH",
     .init = ch_init,
     .step = ch_step,
+    .state_bytes = sizeof(CHState),
 };
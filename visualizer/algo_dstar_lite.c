@@ -68,8 +68,8 @@ static void dstar_update_node(DStarState *s, int node) {
 }
 
 static AlgoVis *dstar_init(const MapDef *map) {
-    free(state);
-    state = calloc(1, sizeof(*state));
+    /* Allocated once; reset only the map-sized prefix of each array */
+    if (!state) state = calloc(1, sizeof(*state));
     state->map = map;
     vis_init_cells(&state->vis, map);
     heap_init(&state->heap);
@@ -83,6 +83,7 @@ static AlgoVis *dstar_init(const MapDef *map) {
         state->g[i] = INT_MAX;
         state->rhs[i] = INT_MAX;
         state->parent[i] = -1;
+        state->in_heap[i] = 0;
     }
 
     /* Goal node: rhs = 0 */
@@ -129,6 +130,9 @@ static int dstar_step(AlgoVis *vis) {
     int node = cur.node;
     s->in_heap[node] = 0;
 
+    /* Lazy heap: a consistent node is a stale duplicate entry */
+    if (s->g[node] == s->rhs[node]) return 1;
+
     /* Skip stale entries */
     int cur_key = dstar_key(s, node);
     if (cur.priority > cur_key && s->g[node] != s->rhs[node]) {
@@ -138,9 +142,10 @@ static int dstar_step(AlgoVis *vis) {
     }
 
     s->vis.nodes_explored++;
+    TRACE_EXPAND(node);
 
     if (node != s->vis.start_node && node != s->vis.end_node)
-        s->vis.cells[node] = VIS_CLOSED;
+        vis_set_cell(&s->vis, node, VIS_CLOSED);
 
     int r = node / cols, c = node % cols;
 
@@ -155,9 +160,10 @@ static int dstar_step(AlgoVis *vis) {
             if (s->map_data[ni] != 0) continue;
             s->vis.relaxations++;
             dstar_update_node(s, ni);
+            TRACE_RELAX(ni, s->rhs[ni]);
             if (ni != s->vis.start_node && ni != s->vis.end_node &&
                 s->vis.cells[ni] != VIS_CLOSED)
-                s->vis.cells[ni] = VIS_OPEN;
+                vis_set_cell(&s->vis, ni, VIS_OPEN);
         }
     } else {
         /* Underconsistent: reset and update */
@@ -170,6 +176,7 @@ static int dstar_step(AlgoVis *vis) {
             if (s->map_data[ni] != 0) continue;
             s->vis.relaxations++;
             dstar_update_node(s, ni);
+            TRACE_RELAX(ni, s->rhs[ni]);
         }
     }
 
@@ -179,12 +186,13 @@ trace_path:
     s->vis.done = 1;
     s->vis.found = 1;
     s->vis.path_cost = s->g[start];
+    vis_set_phase(&s->vis, PHASE_UNPACK);
     /* Trace path: follow rhs-optimal neighbors from start to goal */
     {
         int cur_node = start;
         while (cur_node != s->vis.end_node && cur_node != -1) {
             if (cur_node != s->vis.start_node && cur_node != s->vis.end_node)
-                s->vis.cells[cur_node] = VIS_PATH;
+                vis_set_cell(&s->vis, cur_node, VIS_PATH);
             s->vis.path_len++;
             int cr = cur_node / cols, cc = cur_node % cols;
             int best = INT_MAX;
@@ -203,6 +211,7 @@ trace_path:
         }
         if (cur_node == s->vis.end_node) s->vis.path_len++;
     }
+    vis_set_phase(&s->vis, PHASE_DONE);
     return 0;
 }
 
@@ -228,12 +237,13 @@ void dstar_notify_change(DStarState *s, int node) {
     s->vis.found = 0;
     s->vis.path_len = 0;
     s->vis.path_cost = 0;
+    vis_set_phase(&s->vis, PHASE_QUERY);   /* replanning is query work */
 
     /* Clear path cells */
     int total = s->map->rows * s->map->cols;
     for (int i = 0; i < total; i++) {
         if (s->vis.cells[i] == VIS_PATH)
-            s->vis.cells[i] = VIS_CLOSED;
+            vis_set_cell(&s->vis, i, VIS_CLOSED);
     }
 }
 
@@ -245,4 +255,5 @@ AlgoPlugin algo_dstar_lite = {
     .name = "D*Lite",
     .init = dstar_init,
     .step = dstar_step,
+    .state_bytes = sizeof(DStarState),
 };
@@ -22,8 +22,8 @@ typedef struct {
 static FlowFieldState *state;
 
 static AlgoVis *flowfield_init(const MapDef *map) {
-    free(state);
-    state = calloc(1, sizeof(*state));
+    /* Allocated once; reset only the map-sized prefix of each array */
+    if (!state) state = calloc(1, sizeof(*state));
     state->map = map;
     vis_init_cells(&state->vis, map);
     heap_init(&state->heap);
@@ -32,6 +32,7 @@ static AlgoVis *flowfield_init(const MapDef *map) {
     for (int i = 0; i < total; i++) {
         state->int_cost[i] = INT_MAX;
         state->flow_dir[i] = -1;
+        state->closed[i] = 0;
     }
 
     /* Start Dijkstra from GOAL (reversed) */
@@ -40,6 +41,7 @@ static AlgoVis *flowfield_init(const MapDef *map) {
     heap_push(&state->heap, goal, 0);
     state->phase = 0;
     state->trace_node = -1;
+    vis_set_phase(&state->vis, PHASE_PREPROCESS);
 
     return &state->vis;
 }
@@ -55,6 +57,7 @@ static int flowfield_step(AlgoVis *vis) {
         /* Phase 1: Integration — one Dijkstra expansion from goal */
         if (s->heap.size == 0) {
             /* Integration complete, compute flow directions */
+            vis_set_phase(&s->vis, PHASE_EDGES);
             int total = s->map->rows * s->map->cols;
             for (int i = 0; i < total; i++) {
                 if (s->int_cost[i] == INT_MAX) continue;
@@ -80,6 +83,7 @@ static int flowfield_step(AlgoVis *vis) {
             }
 
             s->phase = 1;
+            vis_set_phase(&s->vis, PHASE_QUERY);
             s->trace_node = s->vis.start_node;
             s->vis.path_len = 1;  /* count start node */
             return 1;
@@ -91,9 +95,10 @@ static int flowfield_step(AlgoVis *vis) {
 
         s->closed[node] = 1;
         s->vis.nodes_explored++;
+        TRACE_EXPAND(node);
 
         if (node != s->vis.start_node && node != s->vis.end_node)
-            s->vis.cells[node] = VIS_OPEN;
+            vis_set_cell(&s->vis, node, VIS_OPEN);
 
         /* Check if we've reached the start (wave from goal hit start) */
         if (node == s->vis.start_node) {
@@ -110,6 +115,7 @@ static int flowfield_step(AlgoVis *vis) {
             int new_cost = s->int_cost[node] + 1;
             if (new_cost < s->int_cost[neighbor]) {
                 s->vis.relaxations++;
+                TRACE_RELAX(neighbor, new_cost);
                 s->int_cost[neighbor] = new_cost;
                 heap_push(&s->heap, neighbor, new_cost);
             }
@@ -123,6 +129,7 @@ static int flowfield_step(AlgoVis *vis) {
             s->vis.done = 1;
             s->vis.found = 1;
             s->vis.path_cost = s->int_cost[s->vis.start_node];
+            vis_set_phase(&s->vis, PHASE_DONE);
             return 0;
         }
 
@@ -138,7 +145,7 @@ static int flowfield_step(AlgoVis *vis) {
         int next = get_index(cols, nr, nc);
 
         if (next != s->vis.start_node && next != s->vis.end_node)
-            s->vis.cells[next] = VIS_PATH;
+            vis_set_cell(&s->vis, next, VIS_PATH);
         s->vis.path_len++;
 
         s->trace_node = next;
@@ -150,4 +157,5 @@ AlgoPlugin algo_flowfield = {
     .name = "FlowField",
     .init = flowfield_init,
     .step = flowfield_step,
+    .state_bytes = sizeof(FlowFieldState),
 };
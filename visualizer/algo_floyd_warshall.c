@@ -29,13 +29,17 @@ static int dist[FW_MAX_NODES][FW_MAX_NODES];
 static int nxt[FW_MAX_NODES][FW_MAX_NODES];
 
 static AlgoVis *floyd_warshall_init(const MapDef *map) {
-    memset(&state, 0, sizeof(state));
+    /* node_id/grid_idx are fully rewritten below; no need to clear MAX_NODES */
     state.map = map;
     vis_init_cells(&state.vis, map);
 
     int cols = map->cols;
     int total = map->rows * map->cols;
 
+    /* Node compression, matrix setup and k-iterations are all-pairs
+     * preprocessing; a query is just the next-hop walk */
+    vis_set_phase(&state.vis, PHASE_EDGES);
+
     /* Build compressed node IDs (only non-wall cells) */
     state.node_count = 0;
     for (int i = 0; i < total; i++) {
@@ -74,6 +78,7 @@ static AlgoVis *floyd_warshall_init(const MapDef *map) {
     }
 
     state.fw_k = 0;
+    vis_set_phase(&state.vis, PHASE_PREPROCESS);
     return &state.vis;
 }
 
@@ -85,6 +90,7 @@ static int floyd_warshall_step(AlgoVis *vis) {
     if (s->fw_k >= V) {
         /* Algorithm complete — trace path */
         s->vis.done = 1;
+        vis_set_phase(&s->vis, PHASE_UNPACK);
 
         int start_id = s->node_id[s->vis.start_node];
         int end_id = s->node_id[s->vis.end_node];
@@ -101,12 +107,13 @@ static int floyd_warshall_step(AlgoVis *vis) {
             int grid = s->grid_idx[cur];
             if (grid != s->vis.start_node &&
                 grid != s->vis.end_node)
-                s->vis.cells[grid] = VIS_PATH;
+                vis_set_cell(&s->vis, grid, VIS_PATH);
             s->vis.path_len++;
             cur = nxt[cur][end_id];
         }
         if (cur == end_id) s->vis.path_len++; /* count end node */
 
+        vis_set_phase(&s->vis, PHASE_DONE);
         return 1;
     }
 
@@ -121,6 +128,7 @@ static int floyd_warshall_step(AlgoVis *vis) {
             int through_k = dist[i][k] + dist[k][j];
             if (through_k < dist[i][j]) {
                 s->vis.relaxations++;
+                TRACE_RELAX(s->grid_idx[j], through_k);
                 dist[i][j] = through_k;
                 nxt[i][j] = nxt[i][k];
             }
@@ -136,8 +144,9 @@ static int floyd_warshall_step(AlgoVis *vis) {
                 if (grid != s->vis.start_node &&
                     grid != s->vis.end_node) {
                     if (s->vis.cells[grid] != VIS_OPEN) {
-                        s->vis.cells[grid] = VIS_OPEN;
+                        vis_set_cell(&s->vis, grid, VIS_OPEN);
                         s->vis.nodes_explored++;
+                        TRACE_EXPAND(grid);
                     }
                 }
             }
@@ -148,7 +157,7 @@ static int floyd_warshall_step(AlgoVis *vis) {
     int k_grid = s->grid_idx[k];
     if (k_grid != s->vis.start_node &&
         k_grid != s->vis.end_node)
-        s->vis.cells[k_grid] = VIS_CLOSED;
+        vis_set_cell(&s->vis, k_grid, VIS_CLOSED);
 
     s->fw_k++;
     return 1;
@@ -159,4 +168,5 @@ AlgoPlugin algo_floyd_warshall = {
     .init = floyd_warshall_init,
     .step = floyd_warshall_step,
     .max_nodes = FW_MAX_NODES,
+    .state_bytes = sizeof(state) + sizeof(dist) + sizeof(nxt),
 };
@@ -61,8 +61,8 @@ static void list_prepend_later(FringeState *s, int node) {
 }
 
 static AlgoVis *fringe_init(const MapDef *map) {
-    free(state);
-    state = calloc(1, sizeof(*state));
+    /* Allocated once; reset only the map-sized prefix of each array */
+    if (!state) state = calloc(1, sizeof(*state));
     state->map = map;
     vis_init_cells(&state->vis, map);
 
@@ -79,6 +79,7 @@ static AlgoVis *fringe_init(const MapDef *map) {
     state->now_head = -1;
     state->later_head = -1;
     state->next_threshold = INT_MAX;
+    state->phase = 0;
 
     int start = state->vis.start_node;
     int h = manhattan(map->start_r, map->start_c, map->end_r, map->end_c);
@@ -132,22 +133,25 @@ static int fringe_step(AlgoVis *vis) {
     /* Expand node */
     list_remove(s, node);
     s->vis.nodes_explored++;
+    TRACE_EXPAND(node);
 
     if (node != s->vis.start_node && node != s->vis.end_node)
-        s->vis.cells[node] = VIS_CLOSED;
+        vis_set_cell(&s->vis, node, VIS_CLOSED);
 
     if (node == s->vis.end_node) {
         s->vis.done = 1;
         s->vis.found = 1;
         /* Trace path */
         s->vis.path_cost = s->nodes[node].g;
+        vis_set_phase(&s->vis, PHASE_UNPACK);
         int cur = node;
         while (cur != -1) {
             if (cur != s->vis.start_node && cur != s->vis.end_node)
-                s->vis.cells[cur] = VIS_PATH;
+                vis_set_cell(&s->vis, cur, VIS_PATH);
             s->vis.path_len++;
             cur = s->parent[cur];
         }
+        vis_set_phase(&s->vis, PHASE_DONE);
         return 1;
     }
 
@@ -163,6 +167,7 @@ static int fringe_step(AlgoVis *vis) {
         if (new_g >= s->nodes[neighbor].g) continue;
 
         s->vis.relaxations++;
+        TRACE_RELAX(neighbor, new_g);
         s->nodes[neighbor].g = new_g;
         int h = manhattan(nr, nc, s->map->end_r, s->map->end_c);
         s->nodes[neighbor].f = new_g + h;
@@ -174,7 +179,7 @@ static int fringe_step(AlgoVis *vis) {
         list_prepend_now(s, neighbor);
 
         if (neighbor != s->vis.start_node && neighbor != s->vis.end_node)
-            s->vis.cells[neighbor] = VIS_OPEN;
+            vis_set_cell(&s->vis, neighbor, VIS_OPEN);
     }
 
     return 1;
@@ -184,4 +189,5 @@ AlgoPlugin algo_fringe = {
     .name = "Fringe",
     .init = fringe_init,
     .step = fringe_step,
+    .state_bytes = sizeof(FringeState),
 };
@@ -43,7 +43,7 @@ static void ida_start_iteration(IDAStarState *s) {
         if (s->vis.cells[i] != VIS_WALL &&
             i != s->vis.start_node &&
             i != s->vis.end_node)
-            s->vis.cells[i] = VIS_EMPTY;
+            vis_set_cell(&s->vis, i, VIS_EMPTY);
     }
 
     int start = s->vis.start_node;
@@ -56,7 +56,8 @@ static void ida_start_iteration(IDAStarState *s) {
 }
 
 static AlgoVis *ida_star_init(const MapDef *map) {
-    memset(&state, 0, sizeof(state));
+    /* Reset only the map-sized prefix of each array (not all of MAX_NODES);
+     * on_path/visited are cleared per iteration */
     state.map = map;
     vis_init_cells(&state.vis, map);
 
@@ -118,6 +119,7 @@ static int ida_star_step(AlgoVis *vis) {
 
         /* Push neighbor */
         s->vis.relaxations++;
+        TRACE_RELAX(neighbor, new_g);
         s->on_path[neighbor] = 1;
         s->parent[neighbor] = node;
         s->cost[neighbor] = new_g;
@@ -125,12 +127,13 @@ static int ida_star_step(AlgoVis *vis) {
         if (!s->visited[neighbor]) {
             s->visited[neighbor] = 1;
             s->vis.nodes_explored++;
+            TRACE_EXPAND(neighbor);
         }
 
         /* Color: on current path */
         if (neighbor != s->vis.start_node &&
             neighbor != s->vis.end_node)
-            s->vis.cells[neighbor] = VIS_OPEN;
+            vis_set_cell(&s->vis, neighbor, VIS_OPEN);
 
         /* Check if we found the goal */
         if (neighbor == s->vis.end_node) {
@@ -157,7 +160,7 @@ static int ida_star_step(AlgoVis *vis) {
 
     if (node != s->vis.start_node &&
         node != s->vis.end_node)
-        s->vis.cells[node] = VIS_CLOSED;
+        vis_set_cell(&s->vis, node, VIS_CLOSED);
 
     return 1;
 }
@@ -166,4 +169,5 @@ AlgoPlugin algo_ida_star = {
     .name = "IDA*",
     .init = ida_star_init,
     .step = ida_star_step,
+    .state_bytes = sizeof(IDAStarState),
 };
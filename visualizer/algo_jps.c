@@ -53,7 +53,7 @@ static int jps_jump_iter(JPSState *s, int r, int c, int dr, int dc) {
         /* Color intermediate jumped cells */
         if (idx != s->vis.start_node && idx != s->vis.end_node &&
             s->vis.cells[idx] == VIS_EMPTY)
-            s->vis.cells[idx] = VIS_OPEN;
+            vis_set_cell(&s->vis, idx, VIS_OPEN);
 
         if (idx == end_node)
             return idx;
@@ -76,7 +76,7 @@ static int jps_jump_iter(JPSState *s, int r, int c, int dr, int dc) {
 }
 
 static AlgoVis *jps_init(const MapDef *map) {
-    memset(&state, 0, sizeof(state));
+    /* Reset only the map-sized prefix of each array (not all of MAX_NODES) */
     state.map = map;
     vis_init_cells(&state.vis, map);
     heap_init(&state.heap);
@@ -85,6 +85,7 @@ static AlgoVis *jps_init(const MapDef *map) {
     for (int i = 0; i < total; i++) {
         state.cost[i] = INT_MAX;
         state.parent[i] = -1;
+        state.closed[i] = 0;
     }
 
     int start = state.vis.start_node;
@@ -110,9 +111,10 @@ static int jps_step(AlgoVis *vis) {
 
     s->closed[node] = 1;
     s->vis.nodes_explored++;
+    TRACE_EXPAND(node);
 
     if (node != s->vis.start_node && node != s->vis.end_node)
-        s->vis.cells[node] = VIS_CLOSED;
+        vis_set_cell(&s->vis, node, VIS_CLOSED);
 
     if (node == s->vis.end_node) {
         s->vis.done = 1;
@@ -136,6 +138,7 @@ static int jps_step(AlgoVis *vis) {
 
         if (new_g < s->cost[jp]) {
             s->vis.relaxations++;
+            TRACE_RELAX(jp, new_g);
             s->cost[jp] = new_g;
             s->parent[jp] = node;
             int h = manhattan(jr, jc, s->map->end_r, s->map->end_c);
@@ -148,6 +151,7 @@ static int jps_step(AlgoVis *vis) {
 
 /* Trace path through jump points, filling intermediate cells */
 static void jps_trace_path(JPSState *s) {
+    vis_set_phase(&s->vis, PHASE_UNPACK);
     int end = s->vis.end_node;
     int cols = s->vis.cols;
     s->vis.path_cost = s->cost[end];
@@ -167,7 +171,7 @@ static void jps_trace_path(JPSState *s) {
             while (ir != pr || ic != pc) {
                 int idx = get_index(cols, ir, ic);
                 if (idx != s->vis.start_node && idx != s->vis.end_node)
-                    s->vis.cells[idx] = VIS_PATH;
+                    vis_set_cell(&s->vis, idx, VIS_PATH);
                 s->vis.path_len++;
                 ir += dr;
                 ic += dc;
@@ -178,10 +182,12 @@ static void jps_trace_path(JPSState *s) {
         }
         cur = prev;
     }
+    vis_set_phase(&s->vis, PHASE_DONE);
 }
 
 AlgoPlugin algo_jps = {
     .name = "JPS",
     .init = jps_init,
     .step = jps_step,
+    .state_bytes = sizeof(JPSState),
 };
@@ -87,8 +87,8 @@ static void rsr_mark_perimeter(RSRState *s) {
 }
 
 static AlgoVis *rsr_init(const MapDef *map) {
-    free(state);
-    state = calloc(1, sizeof(*state));
+    /* Allocated once; reset only the map-sized prefix of each array */
+    if (!state) state = calloc(1, sizeof(*state));
     state->map = map;
     vis_init_cells(&state->vis, map);
     heap_init(&state->heap);
@@ -98,10 +98,15 @@ static AlgoVis *rsr_init(const MapDef *map) {
         state->rect_id[i] = -1;
         state->cost[i] = INT_MAX;
         state->parent[i] = -1;
+        state->assigned[i] = 0;
+        state->closed[i] = 0;
+        state->is_perimeter[i] = 0;
     }
+    state->rect_count = 0;
     state->phase = 0;
     state->scan_r = 0;
     state->scan_c = 0;
+    vis_set_phase(&state->vis, PHASE_PREPROCESS);
 
     return &state->vis;
 }
@@ -136,7 +141,7 @@ static int rsr_step(AlgoVis *vis) {
                             int is_edge = (r == rect.r1 || r == rect.r2 ||
                                            c == rect.c1 || c == rect.c2);
                             if (ci != s->vis.start_node && ci != s->vis.end_node) {
-                                s->vis.cells[ci] = is_edge ? VIS_OPEN : VIS_PREPROCESS;
+                                vis_set_cell(&s->vis, ci, is_edge ? VIS_OPEN : VIS_PREPROCESS);
                             }
                         }
                     }
@@ -160,6 +165,7 @@ static int rsr_step(AlgoVis *vis) {
 
         /* Decomposition complete — start A* on perimeter */
         s->phase = 1;
+        vis_set_phase(&s->vis, PHASE_EDGES);
         rsr_mark_perimeter(s);
 
         int start = s->vis.start_node;
@@ -167,6 +173,7 @@ static int rsr_step(AlgoVis *vis) {
         int sr = start / cols, sc = start % cols;
         int h = manhattan(sr, sc, map->end_r, map->end_c);
         heap_push(&s->heap, start, h);
+        vis_set_phase(&s->vis, PHASE_QUERY);
         return 1;
     }
 
@@ -180,9 +187,10 @@ static int rsr_step(AlgoVis *vis) {
 
         s->closed[node] = 1;
         s->vis.nodes_explored++;
+        TRACE_EXPAND(node);
 
         if (node != s->vis.start_node && node != s->vis.end_node)
-            s->vis.cells[node] = VIS_CLOSED;
+            vis_set_cell(&s->vis, node, VIS_CLOSED);
 
         if (node == s->vis.end_node) {
             s->vis.done = 1;
@@ -203,6 +211,7 @@ static int rsr_step(AlgoVis *vis) {
             int new_g = s->cost[node] + 1;
             if (new_g < s->cost[neighbor]) {
                 s->vis.relaxations++;
+                TRACE_RELAX(neighbor, new_g);
                 s->cost[neighbor] = new_g;
                 s->parent[neighbor] = node;
 
@@ -234,7 +243,7 @@ static int rsr_step(AlgoVis *vis) {
                 int h = manhattan(nr, nc, s->map->end_r, s->map->end_c);
                 heap_push(&s->heap, neighbor, new_g + h);
                 if (neighbor != s->vis.start_node && neighbor != s->vis.end_node)
-                    s->vis.cells[neighbor] = VIS_OPEN;
+                    vis_set_cell(&s->vis, neighbor, VIS_OPEN);
             }
         }
 
@@ -248,4 +257,5 @@ AlgoPlugin algo_rsr = {
     .name = "RSR",
     .init = rsr_init,
     .step = rsr_step,
+    .state_bytes = sizeof(RSRState),
 };
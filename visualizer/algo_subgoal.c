@@ -86,11 +86,12 @@ static int direct_reachable(SubgoalState *s, int sg1, int sg2) {
 }
 
 static AlgoVis *subgoal_init(const MapDef *map) {
-    free(state);
-    state = calloc(1, sizeof(*state));
+    /* Allocated once; reset only the map-sized prefix of each array */
+    if (!state) state = calloc(1, sizeof(*state));
     state->map = map;
     vis_init_cells(&state->vis, map);
     heap_init(&state->heap);
+    state->heap.node_cell = state->subgoals;   /* the heap holds subgoal ids */
 
     int total = map->rows * map->cols;
     for (int i = 0; i < total; i++)
@@ -98,12 +99,17 @@ static AlgoVis *subgoal_init(const MapDef *map) {
     for (int i = 0; i < MAX_SUBGOALS + 2; i++) {
         state->cost[i] = INT_MAX;
         state->parent[i] = -1;
+        state->closed_sg[i] = 0;
     }
+    memset(state->sg_adj_count, 0, sizeof(state->sg_adj_count));
+    state->sg_count = 0;
 
     state->phase = 0;
     state->scan_pos = 0;
+    state->edge_i = 0;
     state->start_sg = -1;
     state->end_sg = -1;
+    vis_set_phase(&state->vis, PHASE_PREPROCESS);
 
     return &state->vis;
 }
@@ -130,7 +136,7 @@ static int subgoal_step(AlgoVis *vis) {
                 s->sg_count++;
 
                 if (pos != s->vis.start_node && pos != s->vis.end_node)
-                    s->vis.cells[pos] = VIS_PREPROCESS;
+                    vis_set_cell(&s->vis, pos, VIS_PREPROCESS);
 
                 /* Check if start/end are subgoals */
                 if (pos == s->vis.start_node) s->start_sg = idx;
@@ -156,6 +162,7 @@ static int subgoal_step(AlgoVis *vis) {
 
         s->phase = 1;
         s->edge_i = 0;
+        vis_set_phase(&s->vis, PHASE_EDGES);
         return 1;
     }
 
@@ -169,6 +176,7 @@ static int subgoal_step(AlgoVis *vis) {
             int sr = sn / cols, sc = sn % cols;
             int h = manhattan(sr, sc, s->map->end_r, s->map->end_c);
             heap_push(&s->heap, s->start_sg, h);
+            vis_set_phase(&s->vis, PHASE_QUERY);
             return 1;
         }
 
@@ -205,16 +213,18 @@ static int subgoal_step(AlgoVis *vis) {
 
         s->closed_sg[sg] = 1;
         s->vis.nodes_explored++;
+        TRACE_EXPAND(s->subgoals[sg]);
         int node = s->subgoals[sg];
 
         if (node != s->vis.start_node && node != s->vis.end_node)
-            s->vis.cells[node] = VIS_CLOSED;
+            vis_set_cell(&s->vis, node, VIS_CLOSED);
 
         if (sg == s->end_sg) {
             s->vis.done = 1;
             s->vis.found = 1;
             /* Trace path through subgoal parents */
             s->vis.path_cost = s->cost[sg];
+            vis_set_phase(&s->vis, PHASE_UNPACK);
             int csg = sg;
             while (csg >= 0) {
                 int cn = s->subgoals[csg];
@@ -231,7 +241,7 @@ static int subgoal_step(AlgoVis *vis) {
                     while (ir != pr || ic != pc) {
                         int idx = get_index(cols, ir, ic);
                         if (idx != s->vis.start_node && idx != s->vis.end_node)
-                            s->vis.cells[idx] = VIS_PATH;
+                            vis_set_cell(&s->vis, idx, VIS_PATH);
                         s->vis.path_len++;
                         if (ir != pr) ir += dr;
                         else if (ic != pc) ic += dc;
@@ -241,6 +251,7 @@ static int subgoal_step(AlgoVis *vis) {
                 }
                 csg = psg;
             }
+            vis_set_phase(&s->vis, PHASE_DONE);
             return 1;
         }
 
@@ -251,6 +262,7 @@ static int subgoal_step(AlgoVis *vis) {
             int new_g = s->cost[sg] + s->sg_adj_cost[sg][i];
             if (new_g < s->cost[nsg]) {
                 s->vis.relaxations++;
+                TRACE_RELAX(s->subgoals[nsg], new_g);
                 s->cost[nsg] = new_g;
                 s->parent[nsg] = sg;
                 int nn = s->subgoals[nsg];
@@ -258,7 +270,7 @@ static int subgoal_step(AlgoVis *vis) {
                 int h = manhattan(nr, nc, s->map->end_r, s->map->end_c);
                 heap_push(&s->heap, nsg, new_g + h);
                 if (nn != s->vis.start_node && nn != s->vis.end_node)
-                    s->vis.cells[nn] = VIS_OPEN;
+                    vis_set_cell(&s->vis, nn, VIS_OPEN);
             }
         }
 
@@ -272,4 +284,5 @@ AlgoPlugin algo_subgoal = {
     .name = "Subgoal",
     .init = subgoal_init,
     .step = subgoal_step,
+    .state_bytes = sizeof(SubgoalState),
 };
@@ -20,8 +20,8 @@ typedef struct {
 static ThetaState *state;
 
 static AlgoVis *theta_init(const MapDef *map) {
-    free(state);
-    state = calloc(1, sizeof(*state));
+    /* Allocated once; reset only the map-sized prefix of each array */
+    if (!state) state = calloc(1, sizeof(*state));
     state->map = map;
     vis_init_cells(&state->vis, map);
     heap_init(&state->heap);
@@ -30,6 +30,7 @@ static AlgoVis *theta_init(const MapDef *map) {
     for (int i = 0; i < total; i++) {
         state->cost[i] = INT_MAX;
         state->parent[i] = -1;
+        state->closed[i] = 0;
     }
 
     int start = state->vis.start_node;
@@ -42,6 +43,7 @@ static AlgoVis *theta_init(const MapDef *map) {
 
 /* Trace path through parent pointers (may skip cells), rasterize segments */
 static void theta_trace_path(ThetaState *s) {
+    vis_set_phase(&s->vis, PHASE_UNPACK);
     int end = s->vis.end_node;
     int cols = s->vis.cols;
     s->vis.path_cost = s->cost[end];  /* ×100 euclidean */
@@ -64,7 +66,7 @@ static void theta_trace_path(ThetaState *s) {
             while (ir != cr || ic != cc) {
                 int idx = get_index(cols, ir, ic);
                 if (idx != s->vis.start_node && idx != s->vis.end_node)
-                    s->vis.cells[idx] = VIS_PATH;
+                    vis_set_cell(&s->vis, idx, VIS_PATH);
                 s->vis.path_len++;
 
                 int e2 = 2 * err;
@@ -76,6 +78,7 @@ static void theta_trace_path(ThetaState *s) {
         }
         cur = prev;
     }
+    vis_set_phase(&s->vis, PHASE_DONE);
 }
 
 static int theta_step(AlgoVis *vis) {
@@ -92,9 +95,10 @@ static int theta_step(AlgoVis *vis) {
     if (s->closed[node]) return 1;
     s->closed[node] = 1;
     s->vis.nodes_explored++;
+    TRACE_EXPAND(node);
 
     if (node != s->vis.start_node && node != s->vis.end_node)
-        s->vis.cells[node] = VIS_CLOSED;
+        vis_set_cell(&s->vis, node, VIS_CLOSED);
 
     if (node == s->vis.end_node) {
         s->vis.done = 1;
@@ -129,12 +133,13 @@ static int theta_step(AlgoVis *vis) {
                 int new_g = s->cost[par] + euclidean100(pr, pc, nr, nc);
                 if (new_g < s->cost[neighbor]) {
                     s->vis.relaxations++;
+                    TRACE_RELAX(neighbor, new_g);
                     s->cost[neighbor] = new_g;
                     s->parent[neighbor] = par;
                     int h = euclidean100(nr, nc, s->map->end_r, s->map->end_c);
                     heap_push(&s->heap, neighbor, new_g + h);
                     if (neighbor != s->vis.start_node && neighbor != s->vis.end_node)
-                        s->vis.cells[neighbor] = VIS_OPEN;
+                        vis_set_cell(&s->vis, neighbor, VIS_OPEN);
                     used_shortcut = 1;
                 }
             }
@@ -145,12 +150,13 @@ static int theta_step(AlgoVis *vis) {
             int new_g = s->cost[node] + euclidean100(r, c, nr, nc);
             if (new_g < s->cost[neighbor]) {
                 s->vis.relaxations++;
+                TRACE_RELAX(neighbor, new_g);
                 s->cost[neighbor] = new_g;
                 s->parent[neighbor] = node;
                 int h = euclidean100(nr, nc, s->map->end_r, s->map->end_c);
                 heap_push(&s->heap, neighbor, new_g + h);
                 if (neighbor != s->vis.start_node && neighbor != s->vis.end_node)
-                    s->vis.cells[neighbor] = VIS_OPEN;
+                    vis_set_cell(&s->vis, neighbor, VIS_OPEN);
             }
         }
     }
@@ -162,4 +168,6 @@ AlgoPlugin algo_theta = {
     .name = "Theta*",
     .init = theta_init,
     .step = theta_step,
+    .any_angle = 1,
+    .state_bytes = sizeof(ThetaState),
 };
@@ -0,0 +1,1442 @@
+/*
+ * rrrlz-bench — Headless benchmark runner
+ *
+ * Runs every selected algorithm plugin on every selected map without SDL.
+ * Each (algorithm, map) pair gets N warm-up runs followed by M measured
+ * runs; only the step loop is timed (init is excluded, as with the
+ * visualizer's B key). Each pair reports min/median/p90/p99 and an
+ * outlier-trimmed mean with 95% confidence interval. Results go to a
+ * table on stdout and optionally to CSV / JSON files for CI.
+ *
+ * Timing uses CLOCK_MONOTONIC_RAW (not slewed by NTP) or, with
+ * --clock tsc on x86, the invariant TSC calibrated against it. Pin to one
+ * CPU with --cpu to avoid migrations between runs.
+ *
+ * Regression tracking: --save-baseline writes the run as CSV; a later run
+ * with --baseline compares against it and exits 1 if any pair's median
+ * time or nodes_explored grew by more than the threshold, or if a pair
+ * that ran in the baseline is missing or skipped in this run.
+ *
+ * Query workloads: --queries N replaces each map's fixed start/end with N
+ * seeded random start/goal pairs from the same connected component,
+ * bucketed by optimal path length. Each bucket reports queries/sec and
+ * per-query latency (init + search, since every query re-initializes the
+ * plugin), and counts paths whose cost differs from the BFS optimum.
+ *
+ * Moving AI scenarios: --scen FILE loads the .scen and the .map it names
+ * and runs every entry as a query, bucketed by the scenario's own buckets.
+ * Costs of 4-connected plugins are checked against BFS on the loaded grid;
+ * Cost/opt shows the mean ratio to the scenario's octile optimum.
+ * --map-file adds a .map (or binary .rmap, see map_io.h) to the normal map
+ * sweep. Large datasets need a build with bigger grid bounds (see MAX_ROWS
+ * in algo.h, just bench).
+ *
+ * Generated maps: --gen KIND:SIZES[:seed=N][:p=F] adds procedural maps
+ * (see mapgen.h) for scaling sweeps. SIZES is a comma list of WxH or cell
+ * counts (square side rounded up), e.g. --gen maze:1e2,1e4,1e6.
+ *
+ * Usage:
+ *   rrrlz-bench [options] [algo ...]
+ *     --map NAME     Map name prefix, case-insensitive (repeatable; default all)
+ *     --warmup N     Warm-up runs per pair (default 1)
+ *     --reps N       Measured runs per pair (default 10)
+ *     --clock SRC    Timer: raw (CLOCK_MONOTONIC_RAW, default) or tsc
+ *     --cpu N        Pin the process to CPU N
+ *     --perf         Hardware counters around the step loop (Linux perf_event)
+ *     --no-mem       Skip the per-pair peak RSS run (one extra forked run each)
+ *     --trace FILE   Write a Chrome/Perfetto trace (build with -DRRRLZ_TRACE)
+ *     --record DIR   Also record one run per pair as DIR/<alg>_<map>.rrec
+ *     --heat DIR     Per-cell work counts as DIR/<alg>_<map>.heat.csv
+ *                    (build with -DRRRLZ_HEAT)
+ *     --csv FILE     Write CSV results ("-" = stdout)
+ *     --json FILE    Write JSON results ("-" = stdout)
+ *     --save-baseline FILE   Write this run as a baseline (CSV)
+ *     --baseline FILE        Compare against a saved baseline
+ *     --threshold PCT        Allowed median-time growth (default 10)
+ *     --nodes-threshold PCT  Allowed nodes_explored growth (default 0)
+ *     --min-delta US         Ignore median-time changes below US (default 1)
+ *     --queries N            Run N random start/goal queries per map
+ *     --seed S               Workload seed (default 1)
+ *     --bucket-width W       Optimal-length bucket width (default 10)
+ *     --map-file FILE        Add a .map / .rmap file to the maps (repeatable)
+ *     --scen FILE            Run a Moving AI .scen scenario (repeatable)
+ *     --gen SPEC             Add generated maps, KIND:SIZES[:seed=N][:p=F] (repeatable)
+ *     --convert IN OUT       Write map IN (bundled name, file or --gen spec) as
+ *                            .rmap and exit
+ *     algo           Algorithm name prefix (case-insensitive; default all)
+ *
+ * Build:
+ *   just bench
+ */
+
+#define _GNU_SOURCE
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sched.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define HAVE_TSC 1
+#endif
+
+#include "algo.h"
+#include "bench_perf.h"
+#include "bench_stats.h"
+#include "map_io.h"
+#include "mapgen.h"
+#include "plugins.h"
+#include "replay.h"
+#include "trace.h"
+#include "workload.h"
+#include "maps/maps.h"
+
+/* ── Selection ───────────────────────────────────────────────────── */
+
+static AlgoPlugin *algorithms[ALG_MAX];
+static int alg_count = 0;
+
+#define BENCH_MAX_MAPS 64
+
+static const MapDef *maps[BENCH_MAX_MAPS];
+static int map_count = 0;
+
+/* Maps loaded from files (owned, freed at exit) */
+static MapDef *loaded_maps[BENCH_MAX_MAPS];
+static int loaded_count = 0;
+
+static const char *scen_paths[BENCH_MAX_MAPS];
+static int scen_count = 0;
+
+static const char *gen_specs[BENCH_MAX_MAPS];
+static int gen_count = 0;
+
+static int warmup = 1;
+static int reps = 10;
+static int use_tsc = 0;
+static int pin_cpu = -1;
+static const char *csv_path = NULL;
+static const char *json_path = NULL;
+static const char *save_baseline_path = NULL;
+static const char *baseline_path = NULL;
+static double time_threshold = 10.0;
+static double nodes_threshold = 0.0;
+static double min_delta_us = 1.0;
+static int query_count = 0;
+static unsigned long long seed = 1;
+static int bucket_width = 10;
+static int use_perf = 0;
+static int measure_mem = 1;
+static const char *trace_path = NULL;
+static const char *record_dir = NULL;
+static const char *heat_dir = NULL;
+
+/* ── Results ─────────────────────────────────────────────────────── */
+
+typedef struct {
+    const char *alg_name;
+    const char *map_name;
+    int map_rows, map_cols;
+    int skipped;
+    int found;
+    int path_cost;
+    int path_len;
+    int nodes_explored;
+    int relaxations;
+    int steps;
+    SampleStats us;   /* step-loop time statistics, microseconds */
+    double init_us;                       /* median init() time */
+    double phase_us[PHASE_COUNT];         /* median time per phase */
+    PhaseStats phases[PHASE_COUNT];       /* counters, from the last run */
+    double perf[PERF_COUNTERS];           /* median per run, -1 = not measured */
+    size_t state_bytes;                   /* plugin-declared state size */
+    long long peak_rss;                   /* RSS growth of one run, -1 = not measured */
+} BenchResult;
+
+static BenchResult *results = NULL;
+static int result_count = 0;
+static int result_cap = 0;
+
+static BenchResult *new_result(void) {
+    if (result_count == result_cap) {
+        result_cap = result_cap ? result_cap * 2 : 64;
+        results = realloc(results, result_cap * sizeof(*results));
+        if (!results) {
+            fprintf(stderr, "out of memory\n");
+            exit(1);
+        }
+    }
+    BenchResult *b = &results[result_count++];
+    memset(b, 0, sizeof(*b));
+    for (int i = 0; i < PERF_COUNTERS; i++) b->perf[i] = -1.0;
+    b->peak_rss = -1;
+    return b;
+}
+
+/* ── Timing ──────────────────────────────────────────────────────── */
+
+static double raw_us(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC_RAW, &ts);
+    return (double)ts.tv_sec * 1e6 + (double)ts.tv_nsec / 1e3;
+}
+
+#ifdef HAVE_TSC
+static double tsc_per_us = 0.0;
+
+/* Measure TSC frequency against CLOCK_MONOTONIC_RAW over ~50ms */
+static void calibrate_tsc(void) {
+    double t0 = raw_us();
+    unsigned long long c0 = __rdtsc();
+    while (raw_us() - t0 < 50000.0) {}
+    double t1 = raw_us();
+    unsigned long long c1 = __rdtsc();
+    tsc_per_us = (double)(c1 - c0) / (t1 - t0);
+}
+#endif
+
+static double now_us(void) {
+#ifdef HAVE_TSC
+    if (use_tsc) return (double)__rdtsc() / tsc_per_us;
+#endif
+    return raw_us();
+}
+
+static void pin_to_cpu(int cpu) {
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    if (sched_setaffinity(0, sizeof(set), &set) != 0) {
+        perror("sched_setaffinity");
+        exit(1);
+    }
+}
+
+/* Open a trace slice for the next run (no-op without RRRLZ_TRACE) */
+static void trace_pair(const AlgoPlugin *alg, const MapDef *map) {
+#ifdef RRRLZ_TRACE
+    char label[128];
+    snprintf(label, sizeof(label), "%s / %s", alg->name, map->name);
+    TRACE_RUN(label);
+#else
+    (void)alg;
+    (void)map;
+#endif
+}
+
+/* Init + run to completion; returns step-loop time in microseconds.
+ * Phase times come from the plugin (vis_set_phase) and span init too.
+ * With --perf, hardware counters cover the step loop into *perf. */
+static double run_once(const AlgoPlugin *alg, const MapDef *map, AlgoVis **out,
+                       double *init_us, PerfSample *perf) {
+    trace_pair(alg, map);
+    double t0 = now_us();
+    AlgoVis *v = alg->init(map);
+    if (perf) perf_start();
+    double t1 = now_us();
+    while (alg->step(v)) {}
+    double t2 = now_us();
+    if (perf) *perf = perf_stop();
+    if (v->phase != PHASE_DONE) vis_set_phase(v, PHASE_DONE);
+    *out = v;
+    if (init_us) *init_us = t1 - t0;
+    return t2 - t1;
+}
+
+/* ── Memory ──────────────────────────────────────────────────────── */
+
+static long long current_rss(void) {
+    FILE *f = fopen("/proc/self/statm", "r");
+    if (!f) return -1;
+    long long size, resident;
+    int ok = fscanf(f, "%lld %lld", &size, &resident) == 2;
+    fclose(f);
+    return ok ? resident * sysconf(_SC_PAGESIZE) : -1;
+}
+
+/* Peak resident growth of a single init + search, in bytes, or -1. The run
+ * happens in a forked child so the parent's footprint stays flat; main()
+ * measures every pair before timing any, since pages a plugin already
+ * touched in the parent would be inherited as resident and not counted. */
+static long long measure_peak_rss(const AlgoPlugin *alg, const MapDef *map) {
+    long long base = current_rss();
+    int fd[2];
+    if (base < 0 || pipe(fd) != 0) return -1;
+    fflush(stdout);
+    pid_t pid = fork();
+    if (pid < 0) {
+        close(fd[0]);
+        close(fd[1]);
+        return -1;
+    }
+    if (pid == 0) {
+        AlgoVis *v;
+        run_once(alg, map, &v, NULL, NULL);
+        struct rusage ru;
+        long long peak = getrusage(RUSAGE_SELF, &ru) == 0 ? ru.ru_maxrss * 1024LL : -1;
+        ssize_t n = write(fd[1], &peak, sizeof(peak));
+        _exit(n == sizeof(peak) ? 0 : 1);
+    }
+    close(fd[1]);
+    long long peak = -1;
+    if (read(fd[0], &peak, sizeof(peak)) != sizeof(peak)) peak = -1;
+    close(fd[0]);
+    int status;
+    waitpid(pid, &status, 0);
+    if (peak < 0 || !WIFEXITED(status) || WEXITSTATUS(status) != 0) return -1;
+    return peak > base ? peak - base : 0;
+}
+
+/* <dir>/<alg>_<map><ext>; characters of the alg and map names other than
+ * letters and digits become '_' (A* -> A_). Returns 0 if it doesn't fit. */
+static int pair_path(char *path, size_t size, const char *dir,
+                     const AlgoPlugin *alg, const MapDef *map, const char *ext) {
+    int n = snprintf(path, size, "%s/%s_%s%s", dir, alg->name, map->name, ext);
+    if (n < 0 || n >= (int)size) return 0;
+    char *end = path + n - strlen(ext);
+    for (char *p = path + strlen(dir) + 1; p < end; p++)
+        if (!isalnum((unsigned char)*p)) *p = '_';
+    return 1;
+}
+
+/* One untimed run written to <record_dir>/<alg>_<map>.rrec */
+static void record_pair(const AlgoPlugin *alg, const MapDef *map) {
+    char path[1024];
+    if (!pair_path(path, sizeof(path), record_dir, alg, map, ".rrec")) return;
+
+    AlgoVis *v = alg->init(map);
+    RecWriter *w = rec_open(path, alg->name, map, v);
+    if (!w) return;
+    int more;
+    do {
+        more = alg->step(v);
+        rec_step(w, v);
+    } while (more);
+    rec_close(w);
+}
+
+/* One untimed run with a HeatMap bound, written to
+ * <heat_dir>/<alg>_<map>.heat.csv: one row per cell with any count. */
+static void heat_pair(const AlgoPlugin *alg, const MapDef *map) {
+    char path[1024];
+    if (!pair_path(path, sizeof(path), heat_dir, alg, map, ".heat.csv")) return;
+    FILE *f = fopen(path, "w");
+    if (!f) {
+        fprintf(stderr, "--heat: cannot write %s\n", path);
+        return;
+    }
+
+    HeatMap h;
+    heat_alloc(&h, map->rows * map->cols);
+    heat_bind(&h);
+    AlgoVis *v = alg->init(map);
+    while (alg->step(v)) {}
+    heat_bind(NULL);
+
+    fprintf(f, "row,col");
+    for (int k = 0; k < HEAT_KINDS; k++) fprintf(f, ",%s", heat_names[k]);
+    fprintf(f, "\n");
+    for (int i = 0; i < h.cells; i++) {
+        uint32_t any = 0;
+        for (int k = 0; k < HEAT_KINDS; k++) any |= h.count[k][i];
+        if (!any) continue;
+        fprintf(f, "%d,%d", i / map->cols, i % map->cols);
+        for (int k = 0; k < HEAT_KINDS; k++) fprintf(f, ",%u", h.count[k][i]);
+        fprintf(f, "\n");
+    }
+    fclose(f);
+    heat_free(&h);
+}
+
+static void bench_pair(const AlgoPlugin *alg, const MapDef *map,
+                       long long peak_rss) {
+    BenchResult *b = new_result();
+    b->alg_name = alg->name;
+    b->map_name = map->name;
+    b->map_rows = map->rows;
+    b->map_cols = map->cols;
+    b->state_bytes = alg->state_bytes;
+    b->peak_rss = peak_rss;
+
+    if (alg->max_nodes > 0 && map->rows * map->cols > alg->max_nodes) {
+        b->skipped = 1;
+        return;
+    }
+
+    AlgoVis *v = NULL;
+    for (int i = 0; i < warmup; i++)
+        run_once(alg, map, &v, NULL, NULL);
+
+    /* samples[0] = step loop, [1] = init, [2 + p] = phase p */
+    double *samples = malloc((PHASE_COUNT + 2) * reps * sizeof(double));
+    PerfSample *perf = use_perf ? malloc(reps * sizeof(PerfSample)) : NULL;
+    for (int i = 0; i < reps; i++) {
+        samples[i] = run_once(alg, map, &v, &samples[reps + i],
+                              perf ? &perf[i] : NULL);
+        for (int p = 0; p < PHASE_COUNT; p++)
+            samples[(2 + p) * reps + i] = v->phases[p].us;
+    }
+    if (perf) {
+        double *col = malloc(reps * sizeof(double));
+        for (int c = 0; c < PERF_COUNTERS; c++) {
+            for (int i = 0; i < reps; i++) col[i] = perf[i].v[c];
+            b->perf[c] = sample_stats(col, reps).median;
+        }
+        free(col);
+        free(perf);
+    }
+    b->us = sample_stats(samples, reps);
+    b->init_us = sample_stats(samples + reps, reps).median;
+    for (int p = 0; p < PHASE_COUNT; p++) {
+        b->phase_us[p] = sample_stats(samples + (2 + p) * reps, reps).median;
+        b->phases[p] = v->phases[p];
+    }
+    free(samples);
+
+    /* Search counters are deterministic; take them from the last run */
+    b->found = v->found;
+    b->path_cost = v->found ? v->path_cost : -1;
+    b->path_len = v->path_len;
+    b->nodes_explored = v->nodes_explored;
+    b->relaxations = v->relaxations;
+    b->steps = v->steps;
+
+    if (record_dir) record_pair(alg, map);
+    if (heat_dir) heat_pair(alg, map);
+}
+
+/* ── Query workloads ─────────────────────────────────────────────── */
+
+typedef struct {
+    const char *alg_name;
+    const char *map_name;
+    int map_rows, map_cols;
+    int skipped;
+    int bucket;
+    int len_lo, len_hi;    /* BFS optimal-length range of the bucket's queries */
+    int queries;
+    int found;
+    int mismatched;        /* found, but cost != BFS optimum */
+    double ref_ratio;      /* mean found cost / reference length, 0 = none */
+    double qps;
+    SampleStats us;        /* per-query latency, microseconds */
+} WorkloadRow;
+
+static WorkloadRow *wl_rows = NULL;
+static int wl_count = 0;
+static int wl_cap = 0;
+
+static WorkloadRow *new_workload_row(void) {
+    if (wl_count == wl_cap) {
+        wl_cap = wl_cap ? wl_cap * 2 : 64;
+        wl_rows = realloc(wl_rows, wl_cap * sizeof(*wl_rows));
+        if (!wl_rows) {
+            fprintf(stderr, "out of memory\n");
+            exit(1);
+        }
+    }
+    WorkloadRow *w = &wl_rows[wl_count++];
+    memset(w, 0, sizeof(*w));
+    return w;
+}
+
+/* Init + run one query to completion; returns init + step-loop time */
+static double run_query(const AlgoPlugin *alg, const MapDef *map,
+                        const Query *q, AlgoVis **out) {
+    MapDef qm = query_map(map, q);
+    trace_pair(alg, map);
+    double t0 = now_us();
+    AlgoVis *v = alg->init(&qm);
+    while (alg->step(v)) {}
+    double t1 = now_us();
+    *out = v;
+    return t1 - t0;
+}
+
+static void bench_workload(const AlgoPlugin *alg, const MapDef *map,
+                           const Query *queries, int n) {
+    if (alg->max_nodes > 0 && map->rows * map->cols > alg->max_nodes) {
+        WorkloadRow *w = new_workload_row();
+        w->alg_name = alg->name;
+        w->map_name = map->name;
+        w->map_rows = map->rows;
+        w->map_cols = map->cols;
+        w->skipped = 1;
+        return;
+    }
+
+    AlgoVis *v = NULL;
+    for (int pass = 0; pass < warmup; pass++)
+        for (int i = 0; i < n; i++)
+            run_query(alg, map, &queries[i], &v);
+
+    int max_bucket = 0;
+    for (int i = 0; i < n; i++)
+        if (queries[i].bucket > max_bucket) max_bucket = queries[i].bucket;
+
+    double *lat = malloc(n * sizeof(double));
+    int *found = calloc(n, sizeof(int));
+    int *cost = calloc(n, sizeof(int));   /* path cost, if found */
+    int *mismatched = calloc(n, sizeof(int));
+    for (int i = 0; i < n; i++) {
+        lat[i] = run_query(alg, map, &queries[i], &v);
+        found[i] = v->found;
+        cost[i] = v->path_cost;
+        mismatched[i] = v->found && !alg->any_angle &&
+                        v->path_cost != queries[i].opt_len;
+    }
+
+    double *samples = malloc(n * sizeof(double));
+    for (int b = 0; b <= max_bucket; b++) {
+        int k = 0, ref_n = 0;
+        WorkloadRow row = {0};
+        double sum = 0.0, ref_sum = 0.0;
+        row.len_lo = INT_MAX;
+        for (int i = 0; i < n; i++) {
+            const Query *q = &queries[i];
+            if (q->bucket != b) continue;
+            samples[k++] = lat[i];
+            sum += lat[i];
+            row.found += found[i] != 0;
+            row.mismatched += mismatched[i];
+            if (q->opt_len < row.len_lo) row.len_lo = q->opt_len;
+            if (q->opt_len > row.len_hi) row.len_hi = q->opt_len;
+            if (found[i] && q->ref_len > 0.0) {
+                double c = alg->any_angle ? cost[i] / 100.0 : cost[i];
+                ref_sum += c / q->ref_len;
+                ref_n++;
+            }
+        }
+        if (k == 0) continue;
+
+        WorkloadRow *w = new_workload_row();
+        *w = row;
+        w->alg_name = alg->name;
+        w->map_name = map->name;
+        w->map_rows = map->rows;
+        w->map_cols = map->cols;
+        w->bucket = b;
+        w->queries = k;
+        w->ref_ratio = ref_n ? ref_sum / ref_n : 0.0;
+        w->qps = sum > 0.0 ? k * 1e6 / sum : 0.0;
+        w->us = sample_stats(samples, k);
+    }
+
+    free(samples);
+    free(mismatched);
+    free(cost);
+    free(found);
+    free(lat);
+}
+
+static void print_workload_table(void) {
+    printf("%-14s %-12s %-9s %6s %-9s %7s %6s %6s %8s %11s %10s %10s %10s\n",
+           "Algorithm", "Map", "Size", "Bucket", "Length", "Queries", "Found",
+           "Wrong", "Cost/opt", "Queries/s", "Median us", "P90 us", "P99 us");
+    printf("%-14s %-12s %-9s %6s %-9s %7s %6s %6s %8s %11s %10s %10s %10s\n",
+           "---------", "---", "----", "------", "------", "-------", "-----",
+           "-----", "--------", "---------", "---------", "------", "------");
+    for (int i = 0; i < wl_count; i++) {
+        WorkloadRow *w = &wl_rows[i];
+        char size[16], len[16];
+        snprintf(size, sizeof(size), "%dx%d", w->map_cols, w->map_rows);
+        if (w->skipped) {
+            printf("%-14s %-12s %-9s %6s\n", w->alg_name, w->map_name, size,
+                   "SKIP");
+            continue;
+        }
+        char ratio[16];
+        snprintf(len, sizeof(len), "%d-%d", w->len_lo, w->len_hi);
+        if (w->ref_ratio > 0.0) snprintf(ratio, sizeof(ratio), "%.3f", w->ref_ratio);
+        else snprintf(ratio, sizeof(ratio), "--");
+        printf("%-14s %-12s %-9s %6d %-9s %7d %6d %6d %8s %11.0f %10.1f %10.1f %10.1f\n",
+               w->alg_name, w->map_name, size, w->bucket, len, w->queries,
+               w->found, w->mismatched, ratio, w->qps, w->us.median,
+               w->us.p90, w->us.p99);
+    }
+}
+
+/* ── Output ──────────────────────────────────────────────────────── */
+
+static void print_table(void) {
+    printf("%-14s %-12s %-8s %7s %9s %9s %9s %10s %10s %10s %10s %18s %4s %9s %8s\n",
+           "Algorithm", "Map", "Size", "Cost", "Explored", "Relax", "Steps",
+           "Min us", "Median us", "P90 us", "P99 us", "Mean us (95% CI)", "Out",
+           "State MB", "RSS MB");
+    printf("%-14s %-12s %-8s %7s %9s %9s %9s %10s %10s %10s %10s %18s %4s %9s %8s\n",
+           "---------", "---", "----", "----", "--------", "-----", "-----",
+           "------", "---------", "------", "------", "----------------", "---",
+           "--------", "------");
+    for (int i = 0; i < result_count; i++) {
+        BenchResult *b = &results[i];
+        char size[16];
+        snprintf(size, sizeof(size), "%dx%d", b->map_cols, b->map_rows);
+        if (b->skipped) {
+            printf("%-14s %-12s %-8s %7s\n", b->alg_name, b->map_name, size,
+                   "SKIP");
+            continue;
+        }
+        char mean[32], rss[16];
+        snprintf(mean, sizeof(mean), "%.1f +- %.1f", b->us.mean, b->us.ci95);
+        if (b->peak_rss < 0)
+            snprintf(rss, sizeof(rss), "--");
+        else
+            snprintf(rss, sizeof(rss), "%.1f", b->peak_rss / 1048576.0);
+        printf("%-14s %-12s %-8s %7d %9d %9d %9d %10.1f %10.1f %10.1f %10.1f %18s %4d %9.1f %8s\n",
+               b->alg_name, b->map_name, size, b->path_cost,
+               b->nodes_explored, b->relaxations, b->steps,
+               b->us.min, b->us.median, b->us.p90, b->us.p99, mean,
+               b->us.outliers, b->state_bytes / 1048576.0, rss);
+    }
+}
+
+/* Pairs that did setup work (preprocess/edges) before the query */
+static int has_setup(const BenchResult *b) {
+    return !b->skipped && (b->phases[PHASE_PREPROCESS].steps > 0 ||
+                           b->phase_us[PHASE_PREPROCESS] + b->phase_us[PHASE_EDGES] > 0.0);
+}
+
+/* Per-phase medians and per-query cost when setup is shared by N queries */
+static void print_phase_table(void) {
+    int any = 0;
+    for (int i = 0; i < result_count; i++) any |= has_setup(&results[i]);
+    if (!any) return;
+
+    printf("\nPhase breakdown (median us; setup = preprocess + edges, amortized over N queries)\n\n");
+    printf("%-14s %-12s %9s %11s %9s %11s %9s %9s %11s %11s\n",
+           "Algorithm", "Map", "Init us", "Prep us", "Prep st", "Edges us",
+           "Query us", "Unpack us", "@100 us", "@10k us");
+    printf("%-14s %-12s %9s %11s %9s %11s %9s %9s %11s %11s\n",
+           "---------", "---", "-------", "-------", "-------", "--------",
+           "--------", "---------", "-------", "-------");
+    for (int i = 0; i < result_count; i++) {
+        const BenchResult *b = &results[i];
+        if (!has_setup(b)) continue;
+        double setup = b->phase_us[PHASE_PREPROCESS] + b->phase_us[PHASE_EDGES];
+        double per_query = b->phase_us[PHASE_QUERY] + b->phase_us[PHASE_UNPACK];
+        printf("%-14s %-12s %9.1f %11.1f %9d %11.1f %9.1f %9.1f %11.1f %11.1f\n",
+               b->alg_name, b->map_name, b->init_us,
+               b->phase_us[PHASE_PREPROCESS], b->phases[PHASE_PREPROCESS].steps,
+               b->phase_us[PHASE_EDGES], b->phase_us[PHASE_QUERY],
+               b->phase_us[PHASE_UNPACK], setup / 100.0 + per_query,
+               setup / 10000.0 + per_query);
+    }
+}
+
+/* Per-node ratios use nodes_explored; -- where a counter is unavailable */
+static void print_perf_table(void) {
+    printf("\nHardware counters (median per run, step loop only)\n\n");
+    printf("%-14s %-12s %12s %12s %6s %11s %11s %11s\n",
+           "Algorithm", "Map", "Cycles", "Instr", "IPC", "L1D m/node",
+           "LLC m/node", "BrM/node");
+    printf("%-14s %-12s %12s %12s %6s %11s %11s %11s\n",
+           "---------", "---", "------", "-----", "---", "----------",
+           "----------", "--------");
+    for (int i = 0; i < result_count; i++) {
+        const BenchResult *b = &results[i];
+        if (b->skipped) continue;
+        const double *pc = b->perf;
+        char cyc[16], ins[16], ipc[16], l1[16], llc[16], br[16];
+        double nodes = b->nodes_explored > 0 ? b->nodes_explored : 1;
+        snprintf(cyc, sizeof(cyc), pc[PERF_CYCLES] < 0 ? "--" : "%.0f", pc[PERF_CYCLES]);
+        snprintf(ins, sizeof(ins), pc[PERF_INSTRUCTIONS] < 0 ? "--" : "%.0f",
+                 pc[PERF_INSTRUCTIONS]);
+        if (pc[PERF_CYCLES] > 0 && pc[PERF_INSTRUCTIONS] >= 0)
+            snprintf(ipc, sizeof(ipc), "%.2f", pc[PERF_INSTRUCTIONS] / pc[PERF_CYCLES]);
+        else
+            snprintf(ipc, sizeof(ipc), "--");
+        snprintf(l1, sizeof(l1), pc[PERF_L1D_MISSES] < 0 ? "--" : "%.2f",
+                 pc[PERF_L1D_MISSES] / nodes);
+        snprintf(llc, sizeof(llc), pc[PERF_LLC_MISSES] < 0 ? "--" : "%.3f",
+                 pc[PERF_LLC_MISSES] / nodes);
+        snprintf(br, sizeof(br), pc[PERF_BRANCH_MISSES] < 0 ? "--" : "%.2f",
+                 pc[PERF_BRANCH_MISSES] / nodes);
+        printf("%-14s %-12s %12s %12s %6s %11s %11s %11s\n", b->alg_name,
+               b->map_name, cyc, ins, ipc, l1, llc, br);
+    }
+}
+
+static FILE *open_output(const char *path) {
+    if (strcmp(path, "-") == 0) return stdout;
+    FILE *f = fopen(path, "w");
+    if (!f) perror(path);
+    return f;
+}
+
+static void close_output(FILE *f) {
+    if (f != stdout) fclose(f);
+}
+
+/* Names come from --map-file basenames, so they may hold any character.
+ * CSV fields are quoted (doubling inner quotes) when they contain a
+ * comma, quote or line break; JSON strings go through json_write_string()
+ * (trace.h). */
+static void csv_field(FILE *f, const char *s) {
+    if (!s[strcspn(s, ",\"\r\n")]) {
+        fputs(s, f);
+        return;
+    }
+    fputc('"', f);
+    for (; *s; s++) {
+        if (*s == '"') fputc('"', f);
+        fputc(*s, f);
+    }
+    fputc('"', f);
+}
+
+static void write_csv(const char *path) {
+    FILE *f = open_output(path);
+    if (!f) return;
+    fprintf(f, "algorithm,map,rows,cols,skipped,found,path_cost,path_len,"
+               "nodes_explored,relaxations,steps,reps,min_us,median_us,"
+               "p90_us,p99_us,max_us,mean_us,stddev_us,ci95_us,outliers,init_us");
+    for (int p = 0; p < PHASE_COUNT; p++)
+        fprintf(f, ",%s_us,%s_steps,%s_nodes", phase_names[p], phase_names[p],
+                phase_names[p]);
+    for (int c = 0; c < PERF_COUNTERS; c++)
+        fprintf(f, ",%s", perf_counter_names[c]);
+    fprintf(f, ",state_bytes,peak_rss_bytes\n");
+    for (int i = 0; i < result_count; i++) {
+        BenchResult *b = &results[i];
+        const SampleStats *st = &b->us;
+        csv_field(f, b->alg_name);
+        fputc(',', f);
+        csv_field(f, b->map_name);
+        fprintf(f, ",%d,%d,%d,%d,%d,%d,%d,%d,%d,%d,"
+                   "%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%d,%.3f",
+                b->map_rows, b->map_cols,
+                b->skipped, b->found, b->path_cost, b->path_len,
+                b->nodes_explored, b->relaxations, b->steps, st->n,
+                st->min, st->median, st->p90, st->p99, st->max,
+                st->mean, st->stddev, st->ci95, st->outliers, b->init_us);
+        for (int p = 0; p < PHASE_COUNT; p++)
+            fprintf(f, ",%.3f,%d,%d", b->phase_us[p], b->phases[p].steps,
+                    b->phases[p].nodes_explored);
+        for (int c = 0; c < PERF_COUNTERS; c++)
+            fprintf(f, ",%.0f", b->perf[c]);
+        fprintf(f, ",%zu,%lld\n", b->state_bytes, b->peak_rss);
+    }
+    close_output(f);
+}
+
+static void write_json(const char *path) {
+    FILE *f = open_output(path);
+    if (!f) return;
+    fprintf(f, "{\n  \"warmup\": %d,\n  \"reps\": %d,\n  \"clock\": \"%s\",\n"
+               "  \"cpu\": %d,\n  \"results\": [\n",
+            warmup, reps, use_tsc ? "tsc" : "monotonic_raw", pin_cpu);
+    for (int i = 0; i < result_count; i++) {
+        BenchResult *b = &results[i];
+        fprintf(f, "    {\"algorithm\": ");
+        json_write_string(f, b->alg_name);
+        fprintf(f, ", \"map\": ");
+        json_write_string(f, b->map_name);
+        fprintf(f, ", \"rows\": %d, \"cols\": %d, \"skipped\": %s",
+                b->map_rows, b->map_cols,
+                b->skipped ? "true" : "false");
+        if (!b->skipped) {
+            const SampleStats *st = &b->us;
+            fprintf(f, ", \"found\": %s, \"path_cost\": %d, \"path_len\": %d, "
+                       "\"nodes_explored\": %d, \"relaxations\": %d, "
+                       "\"steps\": %d, \"min_us\": %.3f, \"median_us\": %.3f, "
+                       "\"p90_us\": %.3f, \"p99_us\": %.3f, \"max_us\": %.3f, "
+                       "\"mean_us\": %.3f, \"stddev_us\": %.3f, "
+                       "\"ci95_us\": %.3f, \"outliers\": %d",
+                    b->found ? "true" : "false", b->path_cost, b->path_len,
+                    b->nodes_explored, b->relaxations, b->steps,
+                    st->min, st->median, st->p90, st->p99, st->max,
+                    st->mean, st->stddev, st->ci95, st->outliers);
+            fprintf(f, ", \"init_us\": %.3f, \"phases\": {", b->init_us);
+            for (int p = 0; p < PHASE_COUNT; p++)
+                fprintf(f, "%s\"%s\": {\"median_us\": %.3f, \"steps\": %d, "
+                           "\"nodes_explored\": %d, \"relaxations\": %d}",
+                        p ? ", " : "", phase_names[p], b->phase_us[p],
+                        b->phases[p].steps, b->phases[p].nodes_explored,
+                        b->phases[p].relaxations);
+            fprintf(f, "}");
+            if (use_perf) {
+                fprintf(f, ", \"perf\": {");
+                for (int c = 0; c < PERF_COUNTERS; c++)
+                    fprintf(f, "%s\"%s\": %.0f", c ? ", " : "",
+                            perf_counter_names[c], b->perf[c]);
+                fprintf(f, "}");
+            }
+            fprintf(f, ", \"state_bytes\": %zu, \"peak_rss_bytes\": %lld",
+                    b->state_bytes, b->peak_rss);
+        }
+        fprintf(f, "}%s\n", i + 1 < result_count ? "," : "");
+    }
+    fprintf(f, "  ]\n}\n");
+    close_output(f);
+}
+
+static void write_workload_csv(const char *path) {
+    FILE *f = open_output(path);
+    if (!f) return;
+    fprintf(f, "algorithm,map,rows,cols,skipped,bucket,len_lo,len_hi,queries,"
+               "found,mismatched,ref_ratio,qps,min_us,median_us,p90_us,p99_us,"
+               "max_us,mean_us,ci95_us\n");
+    for (int i = 0; i < wl_count; i++) {
+        WorkloadRow *w = &wl_rows[i];
+        const SampleStats *st = &w->us;
+        csv_field(f, w->alg_name);
+        fputc(',', f);
+        csv_field(f, w->map_name);
+        fprintf(f, ",%d,%d,%d,%d,%d,%d,%d,%d,%d,%.4f,%.1f,"
+                   "%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f\n",
+                w->map_rows, w->map_cols,
+                w->skipped, w->bucket, w->len_lo, w->len_hi, w->queries,
+                w->found, w->mismatched, w->ref_ratio, w->qps, st->min, st->median,
+                st->p90, st->p99, st->max, st->mean, st->ci95);
+    }
+    close_output(f);
+}
+
+static void write_workload_json(const char *path) {
+    FILE *f = open_output(path);
+    if (!f) return;
+    fprintf(f, "{\n  \"queries\": %d,\n  \"seed\": %llu,\n"
+               "  \"bucket_width\": %d,\n  \"warmup\": %d,\n"
+               "  \"clock\": \"%s\",\n  \"buckets\": [\n",
+            query_count, seed, bucket_width, warmup,
+            use_tsc ? "tsc" : "monotonic_raw");
+    for (int i = 0; i < wl_count; i++) {
+        WorkloadRow *w = &wl_rows[i];
+        fprintf(f, "    {\"algorithm\": ");
+        json_write_string(f, w->alg_name);
+        fprintf(f, ", \"map\": ");
+        json_write_string(f, w->map_name);
+        fprintf(f, ", \"rows\": %d, \"cols\": %d, \"skipped\": %s",
+                w->map_rows, w->map_cols,
+                w->skipped ? "true" : "false");
+        if (!w->skipped) {
+            const SampleStats *st = &w->us;
+            fprintf(f, ", \"bucket\": %d, \"len_lo\": %d, \"len_hi\": %d, "
+                       "\"queries\": %d, \"found\": %d, \"mismatched\": %d, "
+                       "\"ref_ratio\": %.4f, \"qps\": %.1f, \"min_us\": %.3f, \"median_us\": %.3f, "
+                       "\"p90_us\": %.3f, \"p99_us\": %.3f, \"max_us\": %.3f, "
+                       "\"mean_us\": %.3f, \"ci95_us\": %.3f",
+                    w->bucket, w->len_lo, w->len_hi, w->queries, w->found,
+                    w->mismatched, w->ref_ratio, w->qps, st->min, st->median, st->p90,
+                    st->p99, st->max, st->mean, st->ci95);
+        }
+        fprintf(f, "}%s\n", i + 1 < wl_count ? "," : "");
+    }
+    fprintf(f, "  ]\n}\n");
+    close_output(f);
+}
+
+/* ── Baseline comparison ─────────────────────────────────────────── */
+
+typedef struct {
+    char *alg_name;
+    char *map_name;
+    int skipped;
+    int nodes_explored;
+    double median_us;
+} BaselineEntry;
+
+/* Split a CSV line in place, unquoting fields written by csv_field();
+ * returns field count */
+static int split_csv(char *line, char **fields, int max) {
+    line[strcspn(line, "\r\n")] = '\0';
+    int n = 0;
+    char *p = line;
+    while (n < max) {
+        char *comma;
+        if (*p == '"') {
+            /* Unquote into place; the text only ever moves left */
+            char *out = p;
+            fields[n++] = out;
+            p++;
+            while (*p) {
+                if (*p == '"') {
+                    if (p[1] != '"') { p++; break; }
+                    p++;
+                }
+                *out++ = *p++;
+            }
+            comma = strchr(p, ',');
+            *out = '\0';
+        } else {
+            fields[n++] = p;
+            comma = strchr(p, ',');
+            if (comma) *comma = '\0';
+        }
+        if (!comma) break;
+        p = comma + 1;
+    }
+    return n;
+}
+
+static int column_index(char **fields, int n, const char *name) {
+    for (int i = 0; i < n; i++)
+        if (strcmp(fields[i], name) == 0) return i;
+    return -1;
+}
+
+/* Load a baseline CSV written by --save-baseline (or --csv) */
+static BaselineEntry *load_baseline(const char *path, int *count) {
+    FILE *f = fopen(path, "r");
+    if (!f) {
+        perror(path);
+        exit(2);
+    }
+
+    char line[4096];
+    char *fields[64];
+    if (!fgets(line, sizeof(line), f)) {
+        fprintf(stderr, "%s: empty baseline\n", path);
+        exit(2);
+    }
+    int nf = split_csv(line, fields, 64);
+    int c_alg = column_index(fields, nf, "algorithm");
+    int c_map = column_index(fields, nf, "map");
+    int c_skip = column_index(fields, nf, "skipped");
+    int c_nodes = column_index(fields, nf, "nodes_explored");
+    int c_med = column_index(fields, nf, "median_us");
+    if (c_alg < 0 || c_map < 0 || c_skip < 0 || c_nodes < 0 || c_med < 0) {
+        fprintf(stderr, "%s: not a rrrlz-bench CSV baseline\n", path);
+        exit(2);
+    }
+
+    BaselineEntry *entries = NULL;
+    int n = 0, cap = 0;
+    while (fgets(line, sizeof(line), f)) {
+        nf = split_csv(line, fields, 64);
+        if (nf <= c_med || nf <= c_nodes || nf <= c_map || nf <= c_skip) continue;
+        if (n == cap) {
+            cap = cap ? cap * 2 : 64;
+            entries = realloc(entries, cap * sizeof(*entries));
+        }
+        BaselineEntry *e = &entries[n++];
+        e->alg_name = strdup(fields[c_alg]);
+        e->map_name = strdup(fields[c_map]);
+        e->skipped = atoi(fields[c_skip]);
+        e->nodes_explored = atoi(fields[c_nodes]);
+        e->median_us = atof(fields[c_med]);
+    }
+    fclose(f);
+    *count = n;
+    return entries;
+}
+
+static double pct_change(double base, double cur) {
+    if (base <= 0.0) return cur > 0.0 ? 100.0 : 0.0;
+    return (cur - base) * 100.0 / base;
+}
+
+/* Print comparison table; returns number of regressed pairs */
+static int compare_baseline(const char *path, FILE *out) {
+    int n = 0;
+    BaselineEntry *base = load_baseline(path, &n);
+    int regressions = 0;
+
+    fprintf(out, "\nBaseline: %s (time threshold %.1f%%, nodes threshold %.1f%%)\n\n",
+           path, time_threshold, nodes_threshold);
+    fprintf(out, "%-14s %-12s %12s %12s %8s %9s %9s %8s  %s\n",
+           "Algorithm", "Map", "Base med us", "Med us", "Time", "Base expl",
+           "Explored", "Nodes", "Status");
+    fprintf(out, "%-14s %-12s %12s %12s %8s %9s %9s %8s  %s\n",
+           "---------", "---", "-----------", "------", "----", "---------",
+           "--------", "-----", "------");
+
+    for (int i = 0; i < result_count; i++) {
+        BenchResult *b = &results[i];
+        if (b->skipped) continue;
+
+        BaselineEntry *e = NULL;
+        for (int j = 0; j < n; j++) {
+            if (strcmp(base[j].alg_name, b->alg_name) == 0 &&
+                strcmp(base[j].map_name, b->map_name) == 0) {
+                e = &base[j];
+                break;
+            }
+        }
+        if (!e || e->skipped) {
+            fprintf(out, "%-14s %-12s %12s %12.1f %8s %9s %9d %8s  new\n",
+                   b->alg_name, b->map_name, "--", b->us.median, "--", "--",
+                   b->nodes_explored, "--");
+            continue;
+        }
+
+        double dt = pct_change(e->median_us, b->us.median);
+        double dn = pct_change(e->nodes_explored, b->nodes_explored);
+        /* Sub-microsecond runs are all noise; require an absolute delta too */
+        double abs_dt = b->us.median - e->median_us;
+        int time_bad = dt > time_threshold && abs_dt > min_delta_us;
+        int nodes_bad = dn > nodes_threshold;
+        const char *status = "ok";
+        if (time_bad && nodes_bad) status = "REGRESSED (time, nodes)";
+        else if (time_bad)         status = "REGRESSED (time)";
+        else if (nodes_bad)        status = "REGRESSED (nodes)";
+        else if (dt < -time_threshold && -abs_dt > min_delta_us) status = "faster";
+        if (time_bad || nodes_bad) regressions++;
+
+        fprintf(out, "%-14s %-12s %12.1f %12.1f %+7.1f%% %9d %9d %+7.1f%%  %s\n",
+               b->alg_name, b->map_name, e->median_us, b->us.median, dt,
+               e->nodes_explored, b->nodes_explored, dn, status);
+    }
+
+    /* Pairs that ran in the baseline but did not run now */
+    for (int j = 0; j < n; j++) {
+        BaselineEntry *e = &base[j];
+        if (e->skipped) continue;
+
+        BenchResult *b = NULL;
+        for (int i = 0; i < result_count; i++) {
+            if (strcmp(results[i].alg_name, e->alg_name) == 0 &&
+                strcmp(results[i].map_name, e->map_name) == 0) {
+                b = &results[i];
+                break;
+            }
+        }
+        if (b && !b->skipped) continue;
+
+        regressions++;
+        fprintf(out, "%-14s %-12s %12.1f %12s %8s %9d %9s %8s  %s\n",
+               e->alg_name, e->map_name, e->median_us, "--", "--",
+               e->nodes_explored, "--", "--",
+               b ? "REGRESSED (skipped)" : "REGRESSED (missing)");
+    }
+
+    fprintf(out, "\n%d regression%s\n", regressions, regressions == 1 ? "" : "s");
+    for (int j = 0; j < n; j++) {
+        free(base[j].alg_name);
+        free(base[j].map_name);
+    }
+    free(base);
+    return regressions;
+}
+
+/* ── Main ────────────────────────────────────────────────────────── */
+
+static void usage(void) {
+    printf("Usage: rrrlz-bench [options] [algo ...]\n");
+    printf("  --map NAME     Map name prefix (repeatable, default: all)\n");
+    printf("  --warmup N     Warm-up runs per pair (default 1)\n");
+    printf("  --reps N       Measured runs per pair (default 10)\n");
+    printf("  --clock SRC    Timer: raw (CLOCK_MONOTONIC_RAW, default) or tsc\n");
+    printf("  --cpu N        Pin the process to CPU N\n");
+    printf("  --perf         Hardware counters (cycles, IPC, cache/branch misses)\n");
+    printf("  --no-mem       Skip the per-pair peak RSS run\n");
+    printf("  --trace FILE   Chrome/Perfetto trace JSON (needs -DRRRLZ_TRACE build)\n");
+    printf("  --record DIR   Record one run per pair for visualizer --replay\n");
+    printf("  --heat DIR     Per-cell work counts per pair (needs -DRRRLZ_HEAT build)\n");
+    printf("  --csv FILE     Write CSV results (\"-\" = stdout)\n");
+    printf("  --json FILE    Write JSON results (\"-\" = stdout)\n");
+    printf("  --save-baseline FILE   Write this run as a baseline (CSV)\n");
+    printf("  --baseline FILE        Compare against a baseline, exit 1 on regression\n");
+    printf("  --threshold PCT        Allowed median-time growth (default 10)\n");
+    printf("  --nodes-threshold PCT  Allowed nodes_explored growth (default 0)\n");
+    printf("  --min-delta US         Ignore median-time changes below US (default 1)\n");
+    printf("  --queries N            Run N random start/goal queries per map\n");
+    printf("  --seed S               Workload seed (default 1)\n");
+    printf("  --bucket-width W       Optimal-length bucket width (default 10)\n");
+    printf("  --map-file FILE        Add a .map / .rmap file (repeatable)\n");
+    printf("  --scen FILE            Run a Moving AI .scen scenario (repeatable)\n");
+    printf("  --gen SPEC             Add generated maps, KIND:SIZES[:seed=N][:p=F]\n");
+    printf("                         KIND: random maze rooms cave spiral; SIZES: WxH or\n");
+    printf("                         cell counts, comma-separated (e.g. maze:1e2,1e4,1e6)\n");
+    printf("  --convert IN OUT       Write map IN (bundled name, file or --gen spec) as .rmap\n");
+    printf("  algo           Algorithm name prefix (case-insensitive). Available:\n           ");
+    for (int i = 0; i < ALG_MAX; i++)
+        printf(" %s", all_algorithms[i]->name);
+    printf("\n  Maps:\n           ");
+    for (int i = 0; i < MAP_COUNT; i++)
+        printf(" \"%s\"", all_maps[i]->name);
+    printf("\n");
+}
+
+static const char *need_arg(int argc, char *argv[], int *a) {
+    if (*a + 1 >= argc) {
+        fprintf(stderr, "%s: missing argument\n", argv[*a]);
+        exit(2);
+    }
+    return argv[++*a];
+}
+
+static void add_map(const MapDef *m) {
+    for (int j = 0; j < map_count; j++)
+        if (maps[j] == m) return;
+    if (map_count < BENCH_MAX_MAPS) maps[map_count++] = m;
+}
+
+static void add_algorithm(AlgoPlugin *p) {
+    for (int j = 0; j < alg_count; j++)
+        if (algorithms[j] == p) return;
+    if (alg_count < ALG_MAX) algorithms[alg_count++] = p;
+}
+
+/* Expand a --gen spec into generated maps; returns count, -1 on error */
+static int gen_maps(const char *spec, MapDef **out, int max) {
+    MapGenSpec gs;
+    if (mapgen_parse_spec(spec, seed, &gs) != 0) return -1;
+
+    int n = 0;
+    for (int i = 0; i < gs.count && n < max; i++) {
+        MapDef *m = mapgen_generate(gs.kind, gs.rows[i], gs.cols[i], gs.seed,
+                                    gs.density);
+        if (!m) {
+            fprintf(stderr, "--gen: cannot generate %dx%d\n", gs.cols[i], gs.rows[i]);
+            return -1;
+        }
+        out[n++] = m;
+    }
+    return n;
+}
+
+/* --convert: bundled map name, map file or --gen spec -> .rmap */
+static int convert_map(const char *in, const char *out) {
+    const MapDef *src = NULL;
+    MapDef *loaded = NULL;
+    if (strchr(in, ':')) {
+        if (gen_maps(in, &loaded, 1) != 1) return 2;
+        src = loaded;
+    } else if (!strchr(in, '.'))
+        for (int i = 0; i < MAP_COUNT && !src; i++)
+            if (name_prefix_match(in, all_maps[i]->name)) src = all_maps[i];
+    if (!src) src = loaded = map_load_file(in);
+    if (!src) return 2;
+    int rc = map_save_rmap(src, out);
+    if (rc == 0) printf("%s (%dx%d) -> %s\n", src->name, src->cols, src->rows, out);
+    map_free(loaded);
+    return rc == 0 ? 0 : 2;
+}
+
+static void parse_args(int argc, char *argv[]) {
+    for (int a = 1; a < argc; a++) {
+        const char *arg = argv[a];
+
+        if (strcmp(arg, "--help") == 0 || strcmp(arg, "-h") == 0) {
+            usage();
+            exit(0);
+        }
+        if (strcmp(arg, "--warmup") == 0) { warmup = atoi(need_arg(argc, argv, &a)); continue; }
+        if (strcmp(arg, "--reps") == 0)   { reps = atoi(need_arg(argc, argv, &a)); continue; }
+        if (strcmp(arg, "--csv") == 0)    { csv_path = need_arg(argc, argv, &a); continue; }
+        if (strcmp(arg, "--json") == 0)   { json_path = need_arg(argc, argv, &a); continue; }
+        if (strcmp(arg, "--save-baseline") == 0) { save_baseline_path = need_arg(argc, argv, &a); continue; }
+        if (strcmp(arg, "--baseline") == 0)      { baseline_path = need_arg(argc, argv, &a); continue; }
+        if (strcmp(arg, "--threshold") == 0)     { time_threshold = atof(need_arg(argc, argv, &a)); continue; }
+        if (strcmp(arg, "--nodes-threshold") == 0) { nodes_threshold = atof(need_arg(argc, argv, &a)); continue; }
+        if (strcmp(arg, "--min-delta") == 0)     { min_delta_us = atof(need_arg(argc, argv, &a)); continue; }
+        if (strcmp(arg, "--queries") == 0)       { query_count = atoi(need_arg(argc, argv, &a)); continue; }
+        if (strcmp(arg, "--seed") == 0)          { seed = strtoull(need_arg(argc, argv, &a), NULL, 0); continue; }
+        if (strcmp(arg, "--bucket-width") == 0)  { bucket_width = atoi(need_arg(argc, argv, &a)); continue; }
+        if (strcmp(arg, "--cpu") == 0)    { pin_cpu = atoi(need_arg(argc, argv, &a)); continue; }
+        if (strcmp(arg, "--perf") == 0)   { use_perf = 1; continue; }
+        if (strcmp(arg, "--no-mem") == 0) { measure_mem = 0; continue; }
+        if (strcmp(arg, "--record") == 0) { record_dir = need_arg(argc, argv, &a); continue; }
+        if (strcmp(arg, "--heat") == 0) {
+            heat_dir = need_arg(argc, argv, &a);
+#ifndef RRRLZ_HEAT
+            fprintf(stderr, "--heat: rebuild with -DRRRLZ_HEAT "
+                            "(just bench_flags=-DRRRLZ_HEAT bench)\n");
+            exit(2);
+#endif
+            continue;
+        }
+        if (strcmp(arg, "--trace") == 0) {
+            trace_path = need_arg(argc, argv, &a);
+#ifndef RRRLZ_TRACE
+            fprintf(stderr, "--trace: rebuild with -DRRRLZ_TRACE "
+                            "(just bench_flags=-DRRRLZ_TRACE bench)\n");
+            exit(2);
+#endif
+            continue;
+        }
+        if (strcmp(arg, "--clock") == 0) {
+            const char *src = need_arg(argc, argv, &a);
+            if (strcmp(src, "tsc") == 0) {
+#ifdef HAVE_TSC
+                use_tsc = 1;
+#else
+                fprintf(stderr, "--clock tsc: not available on this CPU\n");
+                exit(2);
+#endif
+            } else if (strcmp(src, "raw") != 0) {
+                fprintf(stderr, "unknown clock: %s (raw or tsc)\n", src);
+                exit(2);
+            }
+            continue;
+        }
+        if (strcmp(arg, "--map-file") == 0) {
+            MapDef *m = map_load_file(need_arg(argc, argv, &a));
+            if (!m || !map_fits(m)) exit(2);
+            if (loaded_count < BENCH_MAX_MAPS) loaded_maps[loaded_count++] = m;
+            add_map(m);
+            continue;
+        }
+        if (strcmp(arg, "--convert") == 0) {
+            const char *in = need_arg(argc, argv, &a);
+            const char *out = need_arg(argc, argv, &a);
+            exit(convert_map(in, out));
+        }
+        if (strcmp(arg, "--gen") == 0) {
+            if (gen_count < BENCH_MAX_MAPS) gen_specs[gen_count++] = need_arg(argc, argv, &a);
+            continue;
+        }
+        if (strcmp(arg, "--scen") == 0) {
+            if (scen_count < BENCH_MAX_MAPS) scen_paths[scen_count++] = need_arg(argc, argv, &a);
+            continue;
+        }
+        if (strcmp(arg, "--map") == 0) {
+            const char *name = need_arg(argc, argv, &a);
+            int matched = 0;
+            for (int i = 0; i < MAP_COUNT; i++) {
+                if (name_prefix_match(name, all_maps[i]->name)) {
+                    add_map(all_maps[i]);
+                    matched = 1;
+                }
+            }
+            if (!matched) {
+                fprintf(stderr, "unknown map: %s\n", name);
+                exit(2);
+            }
+            continue;
+        }
+        if (arg[0] == '-') {
+            fprintf(stderr, "unknown option: %s (see --help)\n", arg);
+            exit(2);
+        }
+
+        int matched = 0;
+        for (int i = 0; i < ALG_MAX; i++) {
+            if (name_prefix_match(arg, all_algorithms[i]->name)) {
+                add_algorithm(all_algorithms[i]);
+                matched = 1;
+            }
+        }
+        if (!matched) {
+            fprintf(stderr, "unknown algorithm: %s\n", arg);
+            exit(2);
+        }
+    }
+
+    if (warmup < 0) warmup = 0;
+    if (reps < 1) reps = 1;
+    if (bucket_width < 1) bucket_width = 1;
+    if ((query_count > 0 || scen_count > 0) && (baseline_path || save_baseline_path)) {
+        fprintf(stderr, "--baseline/--save-baseline are not supported with --queries/--scen\n");
+        exit(2);
+    }
+
+    /* Generated after parsing so --seed applies regardless of order */
+    for (int g = 0; g < gen_count; g++) {
+        MapDef *gen[BENCH_MAX_MAPS];
+        int n = gen_maps(gen_specs[g], gen, BENCH_MAX_MAPS - loaded_count);
+        if (n < 0) exit(2);
+        for (int i = 0; i < n; i++) {
+            loaded_maps[loaded_count++] = gen[i];
+            if (!map_fits(gen[i])) exit(2);
+            add_map(gen[i]);
+        }
+    }
+
+    /* No filters = everything */
+    if (alg_count == 0)
+        for (int i = 0; i < ALG_MAX; i++) add_algorithm(all_algorithms[i]);
+    if (map_count == 0)
+        for (int i = 0; i < MAP_COUNT; i++) add_map(all_maps[i]);
+}
+
+/* Workload mode: same seeded query set for every algorithm on a map */
+static int run_workloads(int quiet) {
+    Query *queries = malloc(query_count * sizeof(Query));
+    for (int mi = 0; mi < map_count; mi++) {
+        int n = workload_generate(maps[mi], seed, query_count, bucket_width,
+                                  queries);
+        if (n == 0) {
+            fprintf(stderr, "%s: no connected start/goal pairs\n", maps[mi]->name);
+            continue;
+        }
+        for (int ai = 0; ai < alg_count; ai++)
+            bench_workload(algorithms[ai], maps[mi], queries, n);
+    }
+    free(queries);
+
+    if (!quiet) {
+        printf("rrrlz-bench: %d algorithms x %d maps, %d queries/map (seed %llu), "
+               "%d warm-up passes, clock %s",
+               alg_count, map_count, query_count, seed, warmup,
+               use_tsc ? "tsc" : "monotonic_raw");
+        if (pin_cpu >= 0) printf(", cpu %d", pin_cpu);
+        printf("\n\n");
+        print_workload_table();
+    }
+    if (csv_path) write_workload_csv(csv_path);
+    if (json_path) write_workload_json(json_path);
+
+    free(wl_rows);
+    return 0;
+}
+
+/* Convert scenario entries to queries on `map`, dropping entries that are
+ * out of bounds, on walls or unreachable under 4-connectivity. Returns -1
+ * if the entries were written for a map of another size. */
+static int scen_queries(const char *path, const MapDef *map,
+                        const ScenEntry *entries, int count, Query *out) {
+    int total = map->rows * map->cols;
+    int *dist = malloc(total * sizeof(int));
+    int last_src = -1, n = 0, dropped = 0;
+    for (int i = 0; i < count; i++) {
+        const ScenEntry *e = &entries[i];
+        if (e->map_w != map->cols || e->map_h != map->rows) {
+            /* Resolved to the wrong map: its queries would mean nothing */
+            fprintf(stderr, "%s: entry %d is for a %dx%d map, %s is %dx%d\n",
+                    path, i + 1, e->map_w, e->map_h, map->name, map->cols,
+                    map->rows);
+            free(dist);
+            return -1;
+        }
+        if (!is_valid(map, e->start_r, e->start_c) ||
+            !is_valid(map, e->end_r, e->end_c)) {
+            dropped++;
+            continue;
+        }
+        int src = get_index(map->cols, e->start_r, e->start_c);
+        if (src != last_src) bfs_distances(map, src, dist);
+        last_src = src;
+        int d = dist[get_index(map->cols, e->end_r, e->end_c)];
+        if (d <= 0) {
+            dropped++;
+            continue;
+        }
+        Query *q = &out[n++];
+        q->start_r = e->start_r;
+        q->start_c = e->start_c;
+        q->end_r = e->end_r;
+        q->end_c = e->end_c;
+        q->opt_len = d;
+        q->bucket = e->bucket;
+        q->ref_len = e->optimal;
+    }
+    free(dist);
+    if (dropped)
+        fprintf(stderr, "%s: skipped %d of %d entries (blocked or not "
+                        "4-connected)\n", path, dropped, count);
+    return n;
+}
+
+/* Scenario mode: every entry of each .scen as a query on its map */
+static int run_scenarios(int quiet) {
+    int total_queries = 0;
+    for (int si = 0; si < scen_count; si++) {
+        char *map_path = NULL;
+        int count = 0;
+        ScenEntry *entries = scen_load(scen_paths[si], &map_path, &count);
+        if (!entries) return 2;
+        MapDef *map = map_load_file(map_path);
+        free(map_path);
+        if (!map || !map_fits(map)) {
+            map_free(map);
+            free(entries);
+            return 2;
+        }
+
+        Query *queries = malloc(count * sizeof(Query));
+        int n = scen_queries(scen_paths[si], map, entries, count, queries);
+        if (n < 0) {
+            free(queries);
+            free(entries);
+            map_free(map);
+            return 2;
+        }
+        total_queries += n;
+        for (int ai = 0; ai < alg_count; ai++)
+            bench_workload(algorithms[ai], map, queries, n);
+
+        /* Rows keep name pointers; the map stays loaded until exit */
+        if (loaded_count < BENCH_MAX_MAPS) loaded_maps[loaded_count++] = map;
+        free(queries);
+        free(entries);
+    }
+
+    if (!quiet) {
+        printf("rrrlz-bench: %d algorithms x %d scenarios, %d queries, "
+               "%d warm-up passes, clock %s",
+               alg_count, scen_count, total_queries, warmup,
+               use_tsc ? "tsc" : "monotonic_raw");
+        if (pin_cpu >= 0) printf(", cpu %d", pin_cpu);
+        printf("\n\n");
+        print_workload_table();
+    }
+    if (csv_path) write_workload_csv(csv_path);
+    if (json_path) write_workload_json(json_path);
+
+    free(wl_rows);
+    return 0;
+}
+
+static void write_trace(void) {
+    long n = trace_write_chrome(trace_path);
+    if (n >= 0 && strcmp(trace_path, "-") != 0)
+        fprintf(stderr, "trace: %ld events -> %s\n", n, trace_path);
+}
+
+static void free_loaded_maps(void) {
+    for (int i = 0; i < loaded_count; i++)
+        map_free(loaded_maps[i]);
+}
+
+int main(int argc, char *argv[]) {
+    parse_args(argc, argv);
+
+    if (pin_cpu >= 0) pin_to_cpu(pin_cpu);
+    if (use_perf && perf_open() == 0) use_perf = 0;
+#ifdef HAVE_TSC
+    if (use_tsc) calibrate_tsc();
+#endif
+
+    /* Keep stdout machine-readable when a file output goes there */
+    int quiet = (csv_path && strcmp(csv_path, "-") == 0) ||
+                (json_path && strcmp(json_path, "-") == 0);
+
+    atexit(free_loaded_maps);
+    if (trace_path) atexit(write_trace);
+    if (scen_count > 0)
+        return run_scenarios(quiet);
+    if (query_count > 0)
+        return run_workloads(quiet);
+
+    int pairs = map_count * alg_count;
+    long long *peak_rss = malloc((pairs ? pairs : 1) * sizeof(long long));
+    for (int k = 0; k < pairs; k++) {
+        const AlgoPlugin *alg = algorithms[k % alg_count];
+        const MapDef *map = maps[k / alg_count];
+        int fits = alg->max_nodes <= 0 || map->rows * map->cols <= alg->max_nodes;
+        peak_rss[k] = measure_mem && fits ? measure_peak_rss(alg, map) : -1;
+    }
+    for (int k = 0; k < pairs; k++)
+        bench_pair(algorithms[k % alg_count], maps[k / alg_count], peak_rss[k]);
+    free(peak_rss);
+
+    if (!quiet) {
+        printf("rrrlz-bench: %d algorithms x %d maps, %d warm-up + %d measured runs",
+               alg_count, map_count, warmup, reps);
+        printf(", clock %s", use_tsc ? "tsc" : "monotonic_raw");
+        if (pin_cpu >= 0) printf(", cpu %d", pin_cpu);
+        printf("\n\n");
+        print_table();
+        print_phase_table();
+        if (use_perf) print_perf_table();
+    }
+    if (csv_path) write_csv(csv_path);
+    if (json_path) write_json(json_path);
+    if (save_baseline_path) write_csv(save_baseline_path);
+
+    int regressions = 0;
+    if (baseline_path) {
+        /* Comparison goes to stderr when stdout carries CSV/JSON */
+        regressions = compare_baseline(baseline_path, quiet ? stderr : stdout);
+    }
+
+    free(results);
+    return regressions > 0 ? 1 : 0;
+}
@@ -0,0 +1,120 @@
+/*
+ * bench_perf.h — Hardware performance counters for rrrlz-bench (Linux)
+ *
+ * Opens cycles, instructions, L1D read misses, LLC misses and branch
+ * misses for the calling thread (user space only, so it works with
+ * perf_event_paranoid <= 2). Counters the CPU or hypervisor does not
+ * expose are skipped; if none open, perf_open() returns 0 and the bench
+ * runs without them. Values are scaled when the kernel multiplexes.
+ */
+
+#ifndef BENCH_PERF_H
+#define BENCH_PERF_H
+
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+enum PerfCounter {
+    PERF_CYCLES,
+    PERF_INSTRUCTIONS,
+    PERF_L1D_MISSES,
+    PERF_LLC_MISSES,
+    PERF_BRANCH_MISSES,
+    PERF_COUNTERS,
+};
+
+static const char *const perf_counter_names[PERF_COUNTERS] = {
+    "cycles", "instructions", "l1d_misses", "llc_misses", "branch_misses",
+};
+
+typedef struct {
+    double v[PERF_COUNTERS];   /* -1 = counter not available */
+} PerfSample;
+
+#ifdef __linux__
+
+static int perf_fd[PERF_COUNTERS] = { -1, -1, -1, -1, -1 };
+
+static inline int perf_open_one(unsigned type, unsigned long long config) {
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = type;
+    attr.config = config;
+    attr.disabled = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    return (int)syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+}
+
+/* Returns the number of counters opened; prints why if none */
+static inline int perf_open(void) {
+    static const struct { unsigned type; unsigned long long config; } ev[PERF_COUNTERS] = {
+        { PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES },
+        { PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS },
+        { PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_L1D |
+                              (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                              (PERF_COUNT_HW_CACHE_RESULT_MISS << 16) },
+        { PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES },
+        { PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES },
+    };
+    int opened = 0, err = 0;
+    for (int i = 0; i < PERF_COUNTERS; i++) {
+        perf_fd[i] = perf_open_one(ev[i].type, ev[i].config);
+        if (perf_fd[i] >= 0) opened++;
+        else err = errno;
+    }
+    if (opened == 0)
+        fprintf(stderr, "perf: hardware counters unavailable (%s); "
+                        "check perf_event_paranoid or VM PMU support\n",
+                strerror(err));
+    return opened;
+}
+
+static inline void perf_start(void) {
+    for (int i = 0; i < PERF_COUNTERS; i++) {
+        if (perf_fd[i] < 0) continue;
+        ioctl(perf_fd[i], PERF_EVENT_IOC_RESET, 0);
+        ioctl(perf_fd[i], PERF_EVENT_IOC_ENABLE, 0);
+    }
+}
+
+static inline PerfSample perf_stop(void) {
+    PerfSample s;
+    for (int i = 0; i < PERF_COUNTERS; i++)
+        if (perf_fd[i] >= 0) ioctl(perf_fd[i], PERF_EVENT_IOC_DISABLE, 0);
+    for (int i = 0; i < PERF_COUNTERS; i++) {
+        unsigned long long buf[3];   /* value, time enabled, time running */
+        s.v[i] = -1.0;
+        if (perf_fd[i] < 0 || read(perf_fd[i], buf, sizeof(buf)) != sizeof(buf))
+            continue;
+        s.v[i] = buf[2] ? (double)buf[0] * buf[1] / buf[2] : 0.0;
+    }
+    return s;
+}
+
+#else /* !__linux__ */
+
+static inline int perf_open(void) {
+    fprintf(stderr, "perf: hardware counters need Linux perf_event\n");
+    return 0;
+}
+static inline void perf_start(void) {}
+static inline PerfSample perf_stop(void) {
+    PerfSample s;
+    for (int i = 0; i < PERF_COUNTERS; i++) s.v[i] = -1.0;
+    return s;
+}
+
+#endif /* __linux__ */
+
+#endif /* BENCH_PERF_H */
@@ -0,0 +1,92 @@
+/*
+ * bench_stats.h — Sample statistics for rrrlz-bench
+ *
+ * Percentiles are taken over all samples. Mean, standard deviation and
+ * the 95% confidence interval exclude outliers (Tukey fences, 1.5 x IQR),
+ * so a single preempted run does not skew the comparison.
+ */
+
+#ifndef BENCH_STATS_H
+#define BENCH_STATS_H
+
+#include <math.h>
+#include <stdlib.h>
+
+typedef struct {
+    int n;            /* total samples */
+    int outliers;     /* samples outside the Tukey fences */
+    double min, max;
+    double median, p90, p99;
+    double mean;      /* over inliers */
+    double stddev;    /* over inliers (sample stddev) */
+    double ci95;      /* half-width of 95% CI of the mean */
+} SampleStats;
+
+static inline int cmp_double(const void *a, const void *b) {
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+/* Linear-interpolated percentile of a sorted array, p in [0, 100] */
+static inline double percentile_sorted(const double *s, int n, double p) {
+    if (n == 0) return 0.0;
+    double rank = p / 100.0 * (n - 1);
+    int lo = (int)rank;
+    if (lo >= n - 1) return s[n - 1];
+    double frac = rank - lo;
+    return s[lo] + (s[lo + 1] - s[lo]) * frac;
+}
+
+/* Two-sided 95% Student t critical value for df degrees of freedom */
+static inline double t_crit95(int df) {
+    static const double t[30] = {
+        12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+        2.201,  2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+        2.080,  2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042,
+    };
+    if (df < 1) return 0.0;
+    if (df <= 30) return t[df - 1];
+    return 1.960;
+}
+
+/* Compute stats; sorts samples in place */
+static inline SampleStats sample_stats(double *samples, int n) {
+    SampleStats st = {0};
+    st.n = n;
+    if (n == 0) return st;
+
+    qsort(samples, n, sizeof(double), cmp_double);
+    st.min = samples[0];
+    st.max = samples[n - 1];
+    st.median = percentile_sorted(samples, n, 50.0);
+    st.p90 = percentile_sorted(samples, n, 90.0);
+    st.p99 = percentile_sorted(samples, n, 99.0);
+
+    double q1 = percentile_sorted(samples, n, 25.0);
+    double q3 = percentile_sorted(samples, n, 75.0);
+    double iqr = q3 - q1;
+    double lo = q1 - 1.5 * iqr, hi = q3 + 1.5 * iqr;
+
+    double sum = 0.0;
+    int kept = 0;
+    for (int i = 0; i < n; i++) {
+        if (samples[i] < lo || samples[i] > hi) { st.outliers++; continue; }
+        sum += samples[i];
+        kept++;
+    }
+    st.mean = sum / kept;
+
+    if (kept > 1) {
+        double ss = 0.0;
+        for (int i = 0; i < n; i++) {
+            if (samples[i] < lo || samples[i] > hi) continue;
+            double d = samples[i] - st.mean;
+            ss += d * d;
+        }
+        st.stddev = sqrt(ss / (kept - 1));
+        st.ci95 = t_crit95(kept - 1) * st.stddev / sqrt((double)kept);
+    }
+    return st;
+}
+
+#endif /* BENCH_STATS_H */
@@ -0,0 +1,35 @@
+/*
+ * heat.c — Per-cell work counters
+ */
+
+#include "algo.h"
+#include "heat.h"
+
+const char *const heat_names[HEAT_KINDS] = {
+    "expand", "relax", "push", "los",
+};
+
+#ifdef RRRLZ_HEAT
+_Thread_local HeatMap *heat_cur = NULL;
+#endif
+
+void heat_alloc(HeatMap *h, int cells) {
+    h->cells = cells;
+    for (int k = 0; k < HEAT_KINDS; k++) {
+        h->count[k] = calloc((size_t)cells, sizeof(uint32_t));
+        h->max[k] = 0;
+    }
+}
+
+void heat_free(HeatMap *h) {
+    for (int k = 0; k < HEAT_KINDS; k++)
+        free(h->count[k]);
+    memset(h, 0, sizeof(*h));
+}
+
+void heat_reset(HeatMap *h) {
+    for (int k = 0; k < HEAT_KINDS; k++) {
+        memset(h->count[k], 0, (size_t)h->cells * sizeof(uint32_t));
+        h->max[k] = 0;
+    }
+}
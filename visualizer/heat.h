@@ -0,0 +1,69 @@
+/*
+ * heat.h — Optional per-cell work counters
+ *
+ * AlgoVis.cells only says what state a cell is in, not how much work the
+ * search spent there. Built with -DRRRLZ_HEAT, the trace hooks (trace.h)
+ * and line_of_sight() also count, per cell, how often it was expanded,
+ * relaxed, pushed onto a heap and crossed by a line-of-sight check. The
+ * counts go to the HeatMap bound to the calling thread with heat_bind(),
+ * so lanes stepping on different threads keep separate maps; with no map
+ * bound nothing is counted.
+ *
+ * Without RRRLZ_HEAT, HEAT_COUNT expands to nothing and heat_bind() is a
+ * no-op, so plugins pay nothing for the hooks.
+ */
+
+#ifndef HEAT_H
+#define HEAT_H
+
+#include <stdint.h>
+
+enum HeatKind {
+    HEAT_EXPAND,        /* node expanded / closed */
+    HEAT_RELAX,         /* node's cost improved */
+    HEAT_PUSH,          /* node pushed onto a heap */
+    HEAT_LOS,           /* cell crossed by a line-of-sight check */
+    HEAT_KINDS
+};
+
+extern const char *const heat_names[HEAT_KINDS];
+
+typedef struct {
+    int       cells;
+    uint32_t *count[HEAT_KINDS];   /* [kind][cell] */
+    uint32_t  max[HEAT_KINDS];     /* largest count of each kind */
+} HeatMap;
+
+/* Zeroed counters for `cells` cells; release with heat_free() */
+void heat_alloc(HeatMap *h, int cells);
+void heat_free(HeatMap *h);
+void heat_reset(HeatMap *h);
+
+#ifdef RRRLZ_HEAT
+
+#define HEAT_ENABLED 1
+
+extern _Thread_local HeatMap *heat_cur;
+
+static inline void heat_bind(HeatMap *h) { heat_cur = h; }
+
+static inline void heat_count(int kind, int node) {
+    HeatMap *h = heat_cur;
+    if (!h || node < 0 || node >= h->cells) return;
+    uint32_t n = ++h->count[kind][node];
+    if (n > h->max[kind]) h->max[kind] = n;
+}
+
+#define HEAT_COUNT(kind, node)  heat_count((kind), (node))
+
+#else /* !RRRLZ_HEAT */
+
+#define HEAT_ENABLED 0
+
+static inline void heat_bind(HeatMap *h) { (void)h; }
+
+#define HEAT_COUNT(kind, node)  ((void)0)
+
+#endif /* RRRLZ_HEAT */
+
+#endif /* HEAT_H */
@@ -0,0 +1,74 @@
+/*
+ * lod.c — Level-of-detail aggregation of cell states
+ */
+
+#include "lod.h"
+
+/* Higher wins when a block holds several states */
+static const uint8_t lod_priority[LOD_STATES] = {
+    [VIS_WALL]       = 0,
+    [VIS_EMPTY]      = 1,
+    [VIS_PREPROCESS] = 2,
+    [VIS_CLOSED]     = 3,
+    [VIS_OPEN]       = 4,
+    [VIS_END]        = 5,
+    [VIS_START]      = 6,
+    [VIS_PATH]       = 7,
+};
+
+static int block_of(const Lod *l, int idx) {
+    int r = idx / l->cols, c = idx % l->cols;
+    return (r / l->block) * l->bcols + c / l->block;
+}
+
+/* Highest-priority state present in block b */
+static uint8_t block_state(const Lod *l, int b) {
+    const uint16_t *n = l->counts + (size_t)b * LOD_STATES;
+    int best = VIS_WALL;
+    for (int s = 0; s < LOD_STATES; s++)
+        if (n[s] && lod_priority[s] > lod_priority[best]) best = s;
+    return (uint8_t)best;
+}
+
+void lod_build(Lod *l, const uint8_t *cells, int rows, int cols, int block) {
+    l->rows = rows;
+    l->cols = cols;
+    l->block = block;
+    l->brows = (rows + block - 1) / block;
+    l->bcols = (cols + block - 1) / block;
+    int nblocks = l->brows * l->bcols;
+    l->state = malloc(nblocks);
+    if (block == 1) {
+        l->counts = NULL;
+        memcpy(l->state, cells, nblocks);
+        return;
+    }
+    l->counts = calloc((size_t)nblocks * LOD_STATES, sizeof(uint16_t));
+    for (int i = 0; i < rows * cols; i++)
+        l->counts[(size_t)block_of(l, i) * LOD_STATES + cells[i]]++;
+    for (int b = 0; b < nblocks; b++)
+        l->state[b] = block_state(l, b);
+}
+
+void lod_free(Lod *l) {
+    free(l->counts);
+    free(l->state);
+    memset(l, 0, sizeof(*l));
+}
+
+int lod_update(Lod *l, int idx, int from, int to) {
+    if (l->block == 1) {
+        l->state[idx] = (uint8_t)to;
+        return idx;
+    }
+    int b = block_of(l, idx);
+    uint16_t *n = l->counts + (size_t)b * LOD_STATES;
+    n[from]--;
+    n[to]++;
+    uint8_t old = l->state[b];
+    if (lod_priority[to] > lod_priority[old])
+        l->state[b] = (uint8_t)to;
+    else if (from == old && n[from] == 0)
+        l->state[b] = block_state(l, b);
+    return l->state[b] != old ? b : -1;
+}
@@ -0,0 +1,38 @@
+/*
+ * lod.h — Level-of-detail aggregation of cell states
+ *
+ * When the visualizer is zoomed out below one pixel per cell it draws
+ * blocks of block x block cells, each shown as the highest-priority state
+ * inside it (path over frontier over visited over empty over wall), so a
+ * one-cell-wide path or frontier stays visible. Per-block state counts make
+ * a cell change O(1): lod_update() adjusts two counts and rescans the
+ * block's counts only when the last cell in its shown state leaves.
+ */
+
+#ifndef LOD_H
+#define LOD_H
+
+#include <stdint.h>
+
+#include "algo.h"
+
+#define LOD_STATES     (VIS_PREPROCESS + 1)
+#define LOD_MAX_BLOCK  128   /* block * block cells must fit the uint16 counts */
+
+typedef struct {
+    int       rows, cols;     /* cells */
+    int       block;          /* cells per block side, a power of two */
+    int       brows, bcols;   /* blocks */
+    uint16_t *counts;         /* [block][state] cells in each state; NULL at block 1 */
+    uint8_t  *state;          /* shown state per block */
+} Lod;
+
+/* Aggregate `cells` (rows x cols) into blocks; release with lod_free() */
+void lod_build(Lod *l, const uint8_t *cells, int rows, int cols, int block);
+void lod_free(Lod *l);
+
+/* Cell idx went from state `from` to `to`. Returns the block index if the
+ * block's shown state changed, else -1. */
+int lod_update(Lod *l, int idx, int from, int to);
+
+#endif /* LOD_H */
@@ -0,0 +1,85 @@
+/*
+ * map_info.c — Derived map metadata, computed once per map
+ */
+
+#include "map_info.h"
+
+int label_components(const MapDef *map, int *comp) {
+    int total = map->rows * map->cols;
+    int cols = map->cols;
+    int *queue = malloc(total * sizeof(int));
+    int ncomp = 0;
+
+    for (int i = 0; i < total; i++)
+        comp[i] = -1;
+
+    for (int i = 0; i < total; i++) {
+        if (map->data[i] != 0 || comp[i] >= 0) continue;
+        int head = 0, tail = 0;
+        queue[tail++] = i;
+        comp[i] = ncomp;
+        while (head < tail) {
+            int node = queue[head++];
+            int r = node / cols, c = node % cols;
+            for (int d = 0; d < 4; d++) {
+                int nr = r + DR[d], nc = c + DC[d];
+                if (!is_valid(map, nr, nc)) continue;
+                int ni = get_index(cols, nr, nc);
+                if (comp[ni] >= 0) continue;
+                comp[ni] = ncomp;
+                queue[tail++] = ni;
+            }
+        }
+        ncomp++;
+    }
+
+    free(queue);
+    return ncomp;
+}
+
+static void box_add(MapBox *b, int r, int c) {
+    if (r < b->r0) b->r0 = r;
+    if (r > b->r1) b->r1 = r;
+    if (c < b->c0) b->c0 = c;
+    if (c > b->c1) b->c1 = c;
+}
+
+void map_info_compute(const MapDef *map, MapInfo *info) {
+    int total = map->rows * map->cols;
+    info->comp = malloc(total * sizeof(int));
+    info->components = label_components(map, info->comp);
+    info->comp_size = calloc(info->components + 1, sizeof(int));
+    info->comp_box = malloc((info->components + 1) * sizeof(MapBox));
+
+    MapBox empty = {map->rows, map->cols, -1, -1};
+    info->open_box = empty;
+    for (int k = 0; k < info->components; k++)
+        info->comp_box[k] = empty;
+
+    info->open = 0;
+    for (int i = 0; i < total; i++) {
+        int k = info->comp[i];
+        if (k < 0) continue;
+        int r = i / map->cols, c = i % map->cols;
+        box_add(&info->open_box, r, c);
+        box_add(&info->comp_box[k], r, c);
+        info->comp_size[k]++;
+        info->open++;
+    }
+
+    info->largest = 0;
+    for (int k = 1; k < info->components; k++)
+        if (info->comp_size[k] > info->comp_size[info->largest])
+            info->largest = k;
+    info->start_comp = -1;
+    if (map->start_r >= 0 && map->start_r < map->rows &&
+        map->start_c >= 0 && map->start_c < map->cols)
+        info->start_comp = info->comp[get_index(map->cols, map->start_r, map->start_c)];
+}
+
+void map_info_free(MapInfo *info) {
+    free(info->comp);
+    free(info->comp_size);
+    free(info->comp_box);
+    memset(info, 0, sizeof(*info));
+}
@@ -0,0 +1,38 @@
+/*
+ * map_info.h — Derived map metadata, computed once per map
+ *
+ * Open cell count, 4-connected components and bounding boxes only depend
+ * on the map, so consumers compute a MapInfo when a map is loaded or first
+ * shown and keep it next to the map instead of rescanning the grid.
+ */
+
+#ifndef MAP_INFO_H
+#define MAP_INFO_H
+
+#include "algo.h"
+
+/* Inclusive cell bounds; empty when r1 < r0 */
+typedef struct {
+    int r0, c0, r1, c1;
+} MapBox;
+
+typedef struct {
+    int     open;           /* passable cells */
+    int     components;     /* 4-connected components of open cells */
+    int     largest;        /* index of the component with the most cells */
+    int     start_comp;     /* component of the start cell, -1 if a wall */
+    MapBox  open_box;       /* bounds of all open cells */
+    int    *comp;           /* per cell: component index, -1 for walls */
+    int    *comp_size;      /* per component: open cells */
+    MapBox *comp_box;       /* per component: bounds */
+} MapInfo;
+
+/* Label 4-connected components of open cells. comp[i] = -1 for walls.
+ * Returns number of components. */
+int label_components(const MapDef *map, int *comp);
+
+/* Fill `info` for `map`; release with map_info_free() */
+void map_info_compute(const MapDef *map, MapInfo *info);
+void map_info_free(MapInfo *info);
+
+#endif /* MAP_INFO_H */
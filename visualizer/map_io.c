@@ -0,0 +1,323 @@
+/*
+ * map_io.c — Load maps from files (Moving AI .map / .scen)
+ */
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "map_io.h"
+
+/* Every MapDef handed out is the first member of one of these, so
+ * map_free() knows whether to unmap or free the cell data */
+typedef struct {
+    MapDef def;
+    void  *mapping;       /* mmap base for .rmap, NULL for heap maps */
+    size_t mapping_len;
+} LoadedMap;
+
+MapDef *map_new(const char *name, int rows, int cols, int **cells) {
+    LoadedMap *lm = calloc(1, sizeof(*lm));
+    MapDef *m = &lm->def;
+    *cells = calloc((size_t)rows * cols, sizeof(int));
+    m->name = strdup(name);
+    m->rows = rows;
+    m->cols = cols;
+    m->end_r = rows - 1;
+    m->end_c = cols - 1;
+    m->data = *cells;
+    return m;
+}
+
+static int movingai_passable(char ch) {
+    return ch == '.' || ch == 'G' || ch == 'S';
+}
+
+/* Heap copy of the file's basename without extension */
+static char *map_name_from_path(const char *path) {
+    const char *base = strrchr(path, '/');
+    base = base ? base + 1 : path;
+    const char *dot = strrchr(base, '.');
+    size_t len = dot && dot != base ? (size_t)(dot - base) : strlen(base);
+    char *name = malloc(len + 1);
+    memcpy(name, base, len);
+    name[len] = '\0';
+    return name;
+}
+
+static int map_dims_ok(const char *path, int rows, int cols) {
+    if (rows <= 0 || cols <= 0 || (long long)rows * cols > INT_MAX) {
+        fprintf(stderr, "%s: bad dimensions %dx%d\n", path, cols, rows);
+        return 0;
+    }
+    return 1;
+}
+
+MapDef *map_load_movingai(const char *path) {
+    FILE *f = fopen(path, "r");
+    if (!f) {
+        perror(path);
+        return NULL;
+    }
+
+    char key[32];
+    int rows = -1, cols = -1;
+    char type[32] = "";
+    while (fscanf(f, "%31s", key) == 1) {
+        if (strcmp(key, "map") == 0) break;
+        if (strcmp(key, "type") == 0 && fscanf(f, "%31s", type) == 1) continue;
+        if (strcmp(key, "height") == 0 && fscanf(f, "%d", &rows) == 1) continue;
+        if (strcmp(key, "width") == 0 && fscanf(f, "%d", &cols) == 1) continue;
+        fprintf(stderr, "%s: unexpected header field '%s'\n", path, key);
+        fclose(f);
+        return NULL;
+    }
+    if (!map_dims_ok(path, rows, cols)) {
+        fclose(f);
+        return NULL;
+    }
+
+    char *name = map_name_from_path(path);
+    int *data;
+    MapDef *m = map_new(name, rows, cols, &data);
+    free(name);
+    int start = -1, end = -1;
+    int n = 0, ch;
+    while (n < rows * cols && (ch = fgetc(f)) != EOF) {
+        if (ch == '\n' || ch == '\r') continue;
+        data[n] = movingai_passable((char)ch) ? 0 : 1;
+        if (data[n] == 0) {
+            if (start < 0) start = n;
+            end = n;
+        }
+        n++;
+    }
+    fclose(f);
+
+    if (n < rows * cols) {
+        fprintf(stderr, "%s: truncated map (%d of %d cells)\n", path, n,
+                rows * cols);
+        map_free(m);
+        return NULL;
+    }
+    if (start < 0) start = end = 0;
+
+    m->start_r = start / cols;
+    m->start_c = start % cols;
+    m->end_r = end / cols;
+    m->end_c = end % cols;
+    return m;
+}
+
+static unsigned long long rmap_align(unsigned long long off) {
+    return (off + RMAP_ALIGN - 1) / RMAP_ALIGN * RMAP_ALIGN;
+}
+
+MapDef *map_load_rmap(const char *path) {
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        perror(path);
+        return NULL;
+    }
+    struct stat st;
+    if (fstat(fd, &st) < 0) {
+        perror(path);
+        close(fd);
+        return NULL;
+    }
+    size_t len = (size_t)st.st_size;
+    if (len < sizeof(RmapHeader)) {
+        fprintf(stderr, "%s: too short for an .rmap header\n", path);
+        close(fd);
+        return NULL;
+    }
+    void *base = mmap(NULL, len, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);   /* the mapping keeps the file referenced */
+    if (base == MAP_FAILED) {
+        perror(path);
+        return NULL;
+    }
+
+    const RmapHeader *h = base;
+    const char *err = NULL;
+    unsigned long long cells = (unsigned long long)h->rows * (h->cols > 0 ? h->cols : 0);
+    unsigned long long bytes = cells * sizeof(int);
+    if (memcmp(h->magic, RMAP_MAGIC, 8) != 0)
+        err = "not an .rmap file";
+    else if (h->version != RMAP_VERSION)
+        err = "unsupported .rmap version";
+    else if (h->byte_order != RMAP_BYTE_ORDER)
+        err = "written on a machine with different byte order";
+    else if (memchr(h->name, '\0', RMAP_NAME_LEN) == NULL)
+        err = "unterminated map name";
+    else if (h->start_r < 0 || h->start_r >= h->rows || h->start_c < 0 ||
+             h->start_c >= h->cols || h->end_r < 0 || h->end_r >= h->rows ||
+             h->end_c < 0 || h->end_c >= h->cols)
+        err = "start/end out of range";
+    /* offset + bytes could wrap for a corrupt offset; compare against
+     * what is left of the file after it instead */
+    else if (h->data_offset % RMAP_ALIGN || h->data_offset > len ||
+             bytes > len - h->data_offset)
+        err = "cell data out of range";
+    else if ((h->flags & RMAP_HAS_COST) &&
+             (h->cost_offset % RMAP_ALIGN || h->cost_offset > len ||
+              bytes > len - h->cost_offset))
+        err = "cost layer out of range";
+    if (err) {
+        fprintf(stderr, "%s: %s\n", path, err);
+        munmap(base, len);
+        return NULL;
+    }
+    if (!map_dims_ok(path, h->rows, h->cols)) {
+        munmap(base, len);
+        return NULL;
+    }
+
+    LoadedMap *lm = calloc(1, sizeof(*lm));
+    lm->mapping = base;
+    lm->mapping_len = len;
+    MapDef *m = &lm->def;
+    m->name = h->name;
+    m->rows = h->rows;
+    m->cols = h->cols;
+    m->start_r = h->start_r;
+    m->start_c = h->start_c;
+    m->end_r = h->end_r;
+    m->end_c = h->end_c;
+    m->data = (const int *)((const char *)base + h->data_offset);
+    if (h->flags & RMAP_HAS_COST)
+        m->cost = (const int *)((const char *)base + h->cost_offset);
+    return m;
+}
+
+/* Write `len` bytes then zero-pad the file up to `end` */
+static int write_padded(FILE *f, const void *buf, size_t len, unsigned long long end) {
+    if (fwrite(buf, 1, len, f) != len) return -1;
+    for (long pos = ftell(f); pos >= 0 && (unsigned long long)pos < end; pos++)
+        if (fputc(0, f) == EOF) return -1;
+    return 0;
+}
+
+int map_save_rmap(const MapDef *map, const char *path) {
+    size_t bytes = (size_t)map->rows * map->cols * sizeof(int);
+    RmapHeader h;
+    memset(&h, 0, sizeof(h));
+    memcpy(h.magic, RMAP_MAGIC, 8);
+    h.version = RMAP_VERSION;
+    h.byte_order = RMAP_BYTE_ORDER;
+    h.rows = map->rows;
+    h.cols = map->cols;
+    h.start_r = map->start_r;
+    h.start_c = map->start_c;
+    h.end_r = map->end_r;
+    h.end_c = map->end_c;
+    h.data_offset = RMAP_ALIGN;
+    if (map->cost) {
+        h.flags |= RMAP_HAS_COST;
+        h.cost_offset = rmap_align(h.data_offset + bytes);
+    }
+    snprintf(h.name, sizeof(h.name), "%s", map->name);
+
+    FILE *f = fopen(path, "wb");
+    if (!f) {
+        perror(path);
+        return -1;
+    }
+    int rc = write_padded(f, &h, sizeof(h), h.data_offset);
+    if (rc == 0)
+        rc = write_padded(f, map->data, bytes, map->cost ? h.cost_offset : 0);
+    if (rc == 0 && map->cost)
+        rc = write_padded(f, map->cost, bytes, 0);
+    if (fclose(f) != 0) rc = -1;
+    if (rc != 0) fprintf(stderr, "%s: write failed\n", path);
+    return rc;
+}
+
+MapDef *map_load_file(const char *path) {
+    const char *dot = strrchr(path, '.');
+    if (dot && strcmp(dot, ".map") == 0)
+        return map_load_movingai(path);
+    if (dot && strcmp(dot, ".rmap") == 0)
+        return map_load_rmap(path);
+    fprintf(stderr, "%s: unknown map format (expected .map or .rmap)\n", path);
+    return NULL;
+}
+
+void map_free(MapDef *map) {
+    if (!map) return;
+    LoadedMap *lm = (LoadedMap *)map;
+    if (lm->mapping) {
+        munmap(lm->mapping, lm->mapping_len);
+    } else {
+        free((char *)map->name);
+        free((int *)map->data);
+        free((int *)map->cost);
+    }
+    free(lm);
+}
+
+ScenEntry *scen_load(const char *path, char **map_path, int *count) {
+    FILE *f = fopen(path, "r");
+    if (!f) {
+        perror(path);
+        return NULL;
+    }
+
+    char line[1024];
+    if (!fgets(line, sizeof(line), f) || strncmp(line, "version", 7) != 0) {
+        fprintf(stderr, "%s: missing 'version' header\n", path);
+        fclose(f);
+        return NULL;
+    }
+
+    ScenEntry *entries = NULL;
+    int n = 0, cap = 0;
+    char map_file[512] = "";
+    while (fgets(line, sizeof(line), f)) {
+        ScenEntry e;
+        char mf[512];
+        int w, h, sx, sy, gx, gy;
+        if (sscanf(line, "%d %511s %d %d %d %d %d %d %lf", &e.bucket, mf,
+                   &w, &h, &sx, &sy, &gx, &gy, &e.optimal) != 9)
+            continue;
+        if (!map_file[0]) snprintf(map_file, sizeof(map_file), "%s", mf);
+        e.map_w = w;
+        e.map_h = h;
+        e.start_r = sy;
+        e.start_c = sx;
+        e.end_r = gy;
+        e.end_c = gx;
+        if (n == cap) {
+            cap = cap ? cap * 2 : 256;
+            entries = realloc(entries, cap * sizeof(*entries));
+        }
+        entries[n++] = e;
+    }
+    fclose(f);
+
+    if (n == 0) {
+        fprintf(stderr, "%s: no scenario entries\n", path);
+        free(entries);
+        return NULL;
+    }
+
+    /* Resolve the map next to the scenario unless it exists as given */
+    FILE *probe = fopen(map_file, "r");
+    if (probe) {
+        fclose(probe);
+        *map_path = strdup(map_file);
+    } else {
+        const char *slash = strrchr(path, '/');
+        const char *mbase = strrchr(map_file, '/');
+        mbase = mbase ? mbase + 1 : map_file;
+        int dir_len = slash ? (int)(slash - path + 1) : 0;
+        size_t len = dir_len + strlen(mbase) + 1;
+        *map_path = malloc(len);
+        snprintf(*map_path, len, "%.*s%s", dir_len, path, mbase);
+    }
+
+    *count = n;
+    return entries;
+}
@@ -0,0 +1,89 @@
+/*
+ * map_io.h — Load maps from files
+ *
+ * Moving AI grid benchmark format (https://movingai.com/benchmarks/):
+ *   .map   "type octile / height H / width W / map" header, then H rows of
+ *          terrain symbols. '.', 'G', 'S' are passable; '@', 'O', 'T', 'W'
+ *          and anything else are walls (4-connected plugins have no
+ *          terrain costs).
+ *   .scen  "version 1" header, then one line per query:
+ *          bucket  map  width  height  start_x  start_y  goal_x  goal_y  optimal
+ *          x is the column, y the row; optimal is the octile path length.
+ *   .rmap  rrrlz binary map, loaded with mmap (see RmapHeader). Cells are
+ *          stored as native int32 at a page-aligned offset so MapDef.data
+ *          points straight into the mapping: opening a large world map
+ *          costs no parsing or copying, and processes share the page cache.
+ *
+ * Loaded maps are heap-allocated MapDefs; release with map_free().
+ */
+
+#ifndef MAP_IO_H
+#define MAP_IO_H
+
+#include <stdio.h>
+
+#include "algo.h"
+
+#define RMAP_MAGIC       "RRRLZMAP"
+#define RMAP_VERSION     1
+#define RMAP_BYTE_ORDER  0x01020304u  /* reads differently if endianness differs */
+#define RMAP_ALIGN       4096
+#define RMAP_HAS_COST    0x1u         /* flags: int32 cost layer follows cells */
+#define RMAP_NAME_LEN    48
+
+/* .rmap file layout: header | pad to RMAP_ALIGN | rows*cols int32 cells
+ * (0 = open, 1 = wall) | pad to RMAP_ALIGN | optional rows*cols int32 costs */
+typedef struct {
+    char     magic[8];
+    unsigned version;
+    unsigned byte_order;
+    unsigned flags;
+    int      rows, cols;
+    int      start_r, start_c, end_r, end_c;
+    unsigned long long data_offset;
+    unsigned long long cost_offset;   /* 0 if no cost layer */
+    char     name[RMAP_NAME_LEN];     /* NUL-terminated */
+} RmapHeader;
+
+typedef struct {
+    int bucket;
+    int map_w, map_h;   /* map size the entry was written for */
+    int start_r, start_c, end_r, end_c;
+    double optimal;   /* octile optimal length from the scenario file */
+} ScenEntry;
+
+/* Plugins size their arrays by MAX_NODES; loaders accept any size, callers
+ * that run searches check this first (prints a rebuild hint if not). */
+static inline int map_fits(const MapDef *map) {
+    if ((long long)map->rows * map->cols <= MAX_NODES) return 1;
+    fprintf(stderr, "%s: %dx%d map exceeds MAX_NODES (%d); rebuild with "
+                    "-DMAX_ROWS=... -DMAX_COLS=...\n",
+            map->name, map->cols, map->rows, MAX_NODES);
+    return 0;
+}
+
+/* Heap map of rows x cols open cells (start top-left, end bottom-right).
+ * *cells receives the writable cell array; release with map_free(). */
+MapDef *map_new(const char *name, int rows, int cols, int **cells);
+
+/* Load a Moving AI .map. Start/end default to the first and last open
+ * cells. Returns NULL (after printing why) on error. */
+MapDef *map_load_movingai(const char *path);
+
+/* Map a .rmap file read-only. Returns NULL (after printing why) on error. */
+MapDef *map_load_rmap(const char *path);
+
+/* Write `map` (and its cost layer, if any) as .rmap. Returns 0 on success. */
+int map_save_rmap(const MapDef *map, const char *path);
+
+/* Load a map file, dispatching on extension (.map or .rmap) */
+MapDef *map_load_file(const char *path);
+
+void map_free(MapDef *map);
+
+/* Load a .scen file. *map_path receives the referenced map, resolved
+ * relative to the scenario's directory (caller frees). Returns a malloc'd
+ * array of *count entries, or NULL on error. */
+ScenEntry *scen_load(const char *path, char **map_path, int *count);
+
+#endif /* MAP_IO_H */
@@ -0,0 +1,278 @@
+/*
+ * mapgen.c — Procedural map generators for scaling experiments
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <strings.h>
+
+#include "map_io.h"
+#include "mapgen.h"
+#include "workload.h"
+
+const char *mapgen_kind_names[MAPGEN_KINDS] = {
+    "random", "maze", "rooms", "cave", "spiral",
+};
+
+int mapgen_kind(const char *name) {
+    size_t len = strlen(name);
+    if (len == 0) return -1;
+    for (int k = 0; k < MAPGEN_KINDS; k++)
+        if (strncasecmp(name, mapgen_kind_names[k], len) == 0) return k;
+    return -1;
+}
+
+/* WxH, or a cell count rounded up to a square */
+static int parse_size(const char *tok, int *rows, int *cols) {
+    char *end;
+    if (strchr(tok, 'x')) {
+        *cols = (int)strtol(tok, &end, 10);
+        if (*end != 'x') return -1;
+        *rows = (int)strtol(end + 1, &end, 10);
+    } else {
+        double cells = strtod(tok, &end);
+        *rows = *cols = (int)ceil(sqrt(cells));
+    }
+    return (*end == '\0' && *rows > 0 && *cols > 0) ? 0 : -1;
+}
+
+int mapgen_parse_spec(const char *spec, unsigned long long default_seed,
+                      MapGenSpec *out) {
+    char buf[256];
+    snprintf(buf, sizeof(buf), "%s", spec);
+    char *save = NULL;
+    char *kind_s = strtok_r(buf, ":", &save);
+    char *sizes = strtok_r(NULL, ":", &save);
+    out->kind = kind_s ? mapgen_kind(kind_s) : -1;
+    if (out->kind < 0 || !sizes) {
+        fprintf(stderr, "bad --gen spec '%s' (KIND:SIZES[:seed=N][:p=F])\n", spec);
+        return -1;
+    }
+
+    out->seed = default_seed;
+    out->density = -1.0;
+    for (char *opt; (opt = strtok_r(NULL, ":", &save)); ) {
+        if (strncmp(opt, "seed=", 5) == 0) out->seed = strtoull(opt + 5, NULL, 10);
+        else if (strncmp(opt, "p=", 2) == 0) out->density = atof(opt + 2);
+        else {
+            fprintf(stderr, "--gen: unknown option '%s'\n", opt);
+            return -1;
+        }
+    }
+
+    out->count = 0;
+    char *save2 = NULL;
+    for (char *tok = strtok_r(sizes, ",", &save2); tok;
+         tok = strtok_r(NULL, ",", &save2)) {
+        if (out->count == MAPGEN_MAX_SIZES) {
+            fprintf(stderr, "--gen: more than %d sizes\n", MAPGEN_MAX_SIZES);
+            return -1;
+        }
+        int i = out->count++;
+        if (parse_size(tok, &out->rows[i], &out->cols[i]) != 0) {
+            fprintf(stderr, "--gen: bad size '%s'\n", tok);
+            return -1;
+        }
+    }
+    return 0;
+}
+
+static double rng_unit(Rng *r) {
+    return (rng_next(r) >> 11) * (1.0 / 9007199254740992.0);
+}
+
+static void fill(int *cells, int total, int value) {
+    for (int i = 0; i < total; i++)
+        cells[i] = value;
+}
+
+/* ── Generators ──────────────────────────────────────────────────── */
+
+static void gen_random(int *cells, int rows, int cols, Rng *rng, double p) {
+    for (int i = 0; i < rows * cols; i++)
+        cells[i] = rng_unit(rng) < p;
+}
+
+/* Passages on even coordinates, walls between; iterative backtracker */
+static void gen_maze(int *cells, int rows, int cols, Rng *rng) {
+    int total = rows * cols;
+    fill(cells, total, 1);
+    int *stack = malloc(total * sizeof(int));
+    int sp = 0;
+    cells[0] = 0;
+    stack[sp++] = 0;
+    while (sp > 0) {
+        int node = stack[sp - 1];
+        int r = node / cols, c = node % cols;
+        int dirs[4], nd = 0;
+        for (int d = 0; d < 4; d++) {
+            int nr = r + 2 * DR[d], nc = c + 2 * DC[d];
+            if (nr >= 0 && nr < rows && nc >= 0 && nc < cols &&
+                cells[get_index(cols, nr, nc)])
+                dirs[nd++] = d;
+        }
+        if (nd == 0) {
+            sp--;
+            continue;
+        }
+        int d = dirs[rng_below(rng, nd)];
+        cells[get_index(cols, r + DR[d], c + DC[d])] = 0;
+        int next = get_index(cols, r + 2 * DR[d], c + 2 * DC[d]);
+        cells[next] = 0;
+        stack[sp++] = next;
+    }
+    free(stack);
+}
+
+static void carve_rect(int *cells, int cols, int r0, int c0, int r1, int c1) {
+    for (int r = r0; r <= r1; r++)
+        for (int c = c0; c <= c1; c++)
+            cells[get_index(cols, r, c)] = 0;
+}
+
+/* Rooms of 3..12 cells a side; each new room is joined to the previous */
+static void gen_rooms(int *cells, int rows, int cols, Rng *rng) {
+    int total = rows * cols;
+    if (rows < 5 || cols < 5) {
+        fill(cells, total, 0);
+        return;
+    }
+    fill(cells, total, 1);
+    int target = total / 150 + 2;
+    int attempts = target * 4;
+    int placed = 0, prev_r = 0, prev_c = 0;
+    for (int a = 0; a < attempts && placed < target; a++) {
+        int max_h = rows - 2 < 12 ? rows - 2 : 12;
+        int max_w = cols - 2 < 12 ? cols - 2 : 12;
+        int h = 3 + rng_below(rng, max_h - 2);
+        int w = 3 + rng_below(rng, max_w - 2);
+        int r0 = 1 + rng_below(rng, rows - h - 1);
+        int c0 = 1 + rng_below(rng, cols - w - 1);
+
+        /* Keep a one-cell wall margin to every other room */
+        int clear = 1;
+        for (int r = r0 - 1; r <= r0 + h && clear; r++)
+            for (int c = c0 - 1; c <= c0 + w; c++)
+                if (!cells[get_index(cols, r, c)]) { clear = 0; break; }
+        if (!clear) continue;
+
+        carve_rect(cells, cols, r0, c0, r0 + h - 1, c0 + w - 1);
+        int cr = r0 + h / 2, cc = c0 + w / 2;
+        if (placed > 0) {
+            /* L-shaped corridor: horizontal at prev row, then vertical */
+            carve_rect(cells, cols, prev_r, prev_c < cc ? prev_c : cc,
+                       prev_r, prev_c < cc ? cc : prev_c);
+            carve_rect(cells, cols, prev_r < cr ? prev_r : cr, cc,
+                       prev_r < cr ? cr : prev_r, cc);
+        }
+        prev_r = cr;
+        prev_c = cc;
+        placed++;
+    }
+}
+
+/* Smoothing with the 4-5 rule; out-of-bounds counts as wall */
+static void gen_cave(int *cells, int rows, int cols, Rng *rng, double p) {
+    int total = rows * cols;
+    int *next = malloc(total * sizeof(int));
+    gen_random(cells, rows, cols, rng, p);
+    for (int iter = 0; iter < 5; iter++) {
+        for (int r = 0; r < rows; r++) {
+            for (int c = 0; c < cols; c++) {
+                int walls = 0;
+                for (int dr = -1; dr <= 1; dr++)
+                    for (int dc = -1; dc <= 1; dc++) {
+                        if (dr == 0 && dc == 0) continue;
+                        int nr = r + dr, nc = c + dc;
+                        if (nr < 0 || nr >= rows || nc < 0 || nc >= cols ||
+                            cells[get_index(cols, nr, nc)])
+                            walls++;
+                    }
+                int i = get_index(cols, r, c);
+                next[i] = cells[i] ? walls >= 4 : walls >= 5;
+            }
+        }
+        memcpy(cells, next, total * sizeof(int));
+    }
+    free(next);
+}
+
+/* Rings every 4 cells; gaps alternate between the top-left and
+ * bottom-right corners so the route winds inward */
+static void gen_spiral(int *cells, int rows, int cols) {
+    fill(cells, rows * cols, 0);
+    for (int o = 2, k = 0; rows - 1 - 2 * o > 2 && cols - 1 - 2 * o > 2; o += 4, k++) {
+        int r1 = rows - 1 - o, c1 = cols - 1 - o;
+        for (int c = o; c <= c1; c++) {
+            cells[get_index(cols, o, c)] = 1;
+            cells[get_index(cols, r1, c)] = 1;
+        }
+        for (int r = o; r <= r1; r++) {
+            cells[get_index(cols, r, o)] = 1;
+            cells[get_index(cols, r, c1)] = 1;
+        }
+        if (k % 2 == 0) {
+            cells[get_index(cols, o, o + 1)] = 0;
+            cells[get_index(cols, o, o + 2)] = 0;
+        } else {
+            cells[get_index(cols, r1, c1 - 1)] = 0;
+            cells[get_index(cols, r1, c1 - 2)] = 0;
+        }
+    }
+}
+
+/* ── Endpoints ───────────────────────────────────────────────────── */
+
+/* First and last cell of the largest component; opens a cell if the
+ * generator produced none */
+static void pick_endpoints(MapDef *m, int *cells) {
+    int total = m->rows * m->cols;
+    MapInfo info;
+    map_info_compute(m, &info);
+    if (info.components == 0) {
+        cells[0] = 0;
+        m->start_r = m->start_c = m->end_r = m->end_c = 0;
+        map_info_free(&info);
+        return;
+    }
+
+    int first = -1, last = -1;
+    for (int i = 0; i < total; i++) {
+        if (info.comp[i] != info.largest) continue;
+        if (first < 0) first = i;
+        last = i;
+    }
+    m->start_r = first / m->cols;
+    m->start_c = first % m->cols;
+    m->end_r = last / m->cols;
+    m->end_c = last % m->cols;
+    map_info_free(&info);
+}
+
+MapDef *mapgen_generate(int kind, int rows, int cols,
+                        unsigned long long seed, double density) {
+    if (kind < 0 || kind >= MAPGEN_KINDS || rows <= 0 || cols <= 0 ||
+        (long long)rows * cols > INT_MAX)
+        return NULL;
+
+    char name[64];
+    snprintf(name, sizeof(name), "%s-%dx%d", mapgen_kind_names[kind], cols, rows);
+    int *cells;
+    MapDef *m = map_new(name, rows, cols, &cells);
+    Rng rng = { seed };
+
+    switch (kind) {
+    case 0: gen_random(cells, rows, cols, &rng, density < 0 ? 0.25 : density); break;
+    case 1: gen_maze(cells, rows, cols, &rng); break;
+    case 2: gen_rooms(cells, rows, cols, &rng); break;
+    case 3: gen_cave(cells, rows, cols, &rng, density < 0 ? 0.45 : density); break;
+    case 4: gen_spiral(cells, rows, cols); break;
+    }
+    pick_endpoints(m, cells);
+    if (kind == 4) {
+        /* Goal in the innermost ring, so the route has to wind in */
+        m->end_r = rows / 2;
+        m->end_c = cols / 2;
+    }
+    return m;
+}
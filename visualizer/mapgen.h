@@ -0,0 +1,52 @@
+/*
+ * mapgen.h — Procedural map generators for scaling experiments
+ *
+ * Every generator is deterministic for a given (kind, size, seed, density),
+ * so a sweep from 10x10 to 3163x3163 (10^2..10^7 cells) is reproducible.
+ * Start and end are the first and last cells (row-major) of the largest
+ * 4-connected open region, so every generated map has a path.
+ *
+ *   random  each cell is a wall with probability `density` (default 0.25)
+ *   maze    recursive-backtracker perfect maze, 1-cell corridors
+ *   rooms   random non-overlapping rooms joined by L-shaped corridors
+ *   cave    cellular automaton (initial fill `density`, default 0.45)
+ *   spiral  nested rings, each with one gap on alternating sides; the goal
+ *           is the center cell
+ */
+
+#ifndef MAPGEN_H
+#define MAPGEN_H
+
+#include "algo.h"
+
+/* Kind names, indexed by mapgen_kind() */
+#define MAPGEN_KINDS 5
+extern const char *mapgen_kind_names[MAPGEN_KINDS];
+
+/* Index of a kind name (case-insensitive prefix), -1 if unknown */
+int mapgen_kind(const char *name);
+
+/* A --gen spec, KIND:SIZES[:seed=N][:p=F]. SIZES is a comma-separated
+ * list of WxH or cell counts (N cells = a ceil(sqrt(N)) square). */
+#define MAPGEN_MAX_SIZES 64
+
+typedef struct {
+    int kind;
+    int count;                        /* sizes in the spec */
+    int rows[MAPGEN_MAX_SIZES];
+    int cols[MAPGEN_MAX_SIZES];
+    unsigned long long seed;          /* default_seed unless seed= is given */
+    double density;                   /* < 0 = the kind's default */
+} MapGenSpec;
+
+/* Parse a --gen spec into *out; prints the problem and returns -1 if it
+ * is malformed */
+int mapgen_parse_spec(const char *spec, unsigned long long default_seed,
+                      MapGenSpec *out);
+
+/* Generate a map; density < 0 selects the kind's default. The map is
+ * named "<kind>-<cols>x<rows>"; release with map_free(). */
+MapDef *mapgen_generate(int kind, int rows, int cols,
+                        unsigned long long seed, double density);
+
+#endif /* MAPGEN_H */
@@ -0,0 +1,46 @@
+/* plugins.h — Algorithm plugin registry (shared by visualizer and bench) */
+
+#ifndef PLUGINS_H
+#define PLUGINS_H
+
+#include "algo.h"
+
+extern AlgoPlugin algo_dijkstra;
+extern AlgoPlugin algo_astar;
+extern AlgoPlugin algo_bellman_ford;
+extern AlgoPlugin algo_ida_star;
+extern AlgoPlugin algo_floyd_warshall;
+extern AlgoPlugin algo_jps;
+extern AlgoPlugin algo_fringe;
+extern AlgoPlugin algo_flowfield;
+extern AlgoPlugin algo_dstar_lite;
+extern AlgoPlugin algo_theta;
+extern AlgoPlugin algo_rsr;
+extern AlgoPlugin algo_subgoal;
+extern AlgoPlugin algo_ch;
+extern AlgoPlugin algo_anya;
+
+#define ALG_MAX 14
+
+/* Master list of all algorithms */
+static AlgoPlugin *all_algorithms[ALG_MAX] = {
+    &algo_dijkstra, &algo_astar, &algo_bellman_ford,
+    &algo_ida_star, &algo_floyd_warshall, &algo_jps,
+    &algo_fringe, &algo_flowfield, &algo_dstar_lite,
+    &algo_theta, &algo_rsr, &algo_subgoal,
+    &algo_ch, &algo_anya,
+};
+
+/* Case-insensitive prefix match of a CLI argument against a name */
+static inline int name_prefix_match(const char *arg, const char *name) {
+    for (int k = 0; arg[k]; k++) {
+        char ac = arg[k], nc = name[k];
+        if (!nc) return 0;
+        if (ac >= 'A' && ac <= 'Z') ac += 32;
+        if (nc >= 'A' && nc <= 'Z') nc += 32;
+        if (ac != nc) return 0;
+    }
+    return 1;
+}
+
+#endif /* PLUGINS_H */
@@ -0,0 +1,302 @@
+/*
+ * replay.c — Record search runs and play them back
+ */
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "replay.h"
+
+/* Keyframes (full cell snapshots) for seeking: at least every 64 steps,
+ * sparser when that would exceed this many bytes */
+#define REC_MIN_KEY_EVERY 64
+#define REC_KEY_BUDGET    (64u << 20)
+
+/* The cell snapshot is padded so records stay 4-byte aligned */
+static size_t snapshot_bytes(long long total) {
+    return (size_t)(total + 3) & ~(size_t)3;
+}
+
+/* ── Writing ─────────────────────────────────────────────────────── */
+
+struct RecWriter {
+    FILE          *f;
+    const char    *path;
+    RecHeader      h;
+    int            total;
+    unsigned char *shadow;   /* cell state as of the last record */
+    unsigned      *deltas;   /* scratch, one slot per cell */
+    int            failed;
+};
+
+RecWriter *rec_open(const char *path, const char *alg_name, const MapDef *map,
+                    AlgoVis *vis) {
+    FILE *f = fopen(path, "wb");
+    if (!f) {
+        perror(path);
+        return NULL;
+    }
+    RecWriter *w = calloc(1, sizeof(*w));
+    w->f = f;
+    w->path = path;
+    w->total = map->rows * map->cols;
+    memcpy(w->h.magic, REC_MAGIC, 8);
+    w->h.version = REC_VERSION;
+    w->h.byte_order = REC_BYTE_ORDER;
+    w->h.rows = map->rows;
+    w->h.cols = map->cols;
+    w->h.start_r = map->start_r;
+    w->h.start_c = map->start_c;
+    w->h.end_r = map->end_r;
+    w->h.end_c = map->end_c;
+    snprintf(w->h.alg, sizeof(w->h.alg), "%s", alg_name);
+    snprintf(w->h.map, sizeof(w->h.map), "%s", map->name);
+
+    w->shadow = malloc(w->total);
+    w->deltas = malloc(w->total * sizeof(unsigned));
+    memcpy(w->shadow, vis->cells, w->total);
+    static const unsigned char pad[4];
+    if (fwrite(&w->h, sizeof(w->h), 1, f) != 1 ||
+        fwrite(w->shadow, 1, w->total, f) != (size_t)w->total ||
+        fwrite(pad, 1, snapshot_bytes(w->total) - w->total, f) !=
+            snapshot_bytes(w->total) - w->total)
+        w->failed = 1;
+    rec_step(w, vis);   /* record 0: counters after init, no deltas */
+    return w;
+}
+
+/* Append idx if its state differs from the last record */
+static void rec_delta(RecWriter *w, unsigned *count, int idx, uint8_t st) {
+    if (st == w->shadow[idx]) return;
+    w->shadow[idx] = st;
+    w->deltas[(*count)++] = (unsigned)idx << REC_STATE_BITS | st;
+}
+
+void rec_step(RecWriter *w, AlgoVis *vis) {
+    RecStep s;
+    s.steps = vis->steps;
+    s.nodes_explored = vis->nodes_explored;
+    s.relaxations = vis->relaxations;
+    s.path_len = vis->path_len;
+    s.path_cost = vis->path_cost;
+    s.flags = (vis->done ? REC_DONE : 0) | (vis->found ? REC_FOUND : 0) |
+              (unsigned)vis->phase << REC_PHASE_SHIFT;
+    s.deltas = 0;
+    if (vis->dirty_all) {
+        for (int i = 0; i < w->total; i++)
+            rec_delta(w, &s.deltas, i, vis->cells[i]);
+    } else {
+        for (int k = 0; k < vis->dirty_count; k++)
+            rec_delta(w, &s.deltas, vis->dirty[k], vis->cells[vis->dirty[k]]);
+    }
+    vis_clear_dirty(vis);
+    if (fwrite(&s, sizeof(s), 1, w->f) != 1 ||
+        fwrite(w->deltas, sizeof(unsigned), s.deltas, w->f) != s.deltas)
+        w->failed = 1;
+    w->h.steps++;
+}
+
+int rec_close(RecWriter *w) {
+    /* Patch the step count into the header */
+    if (fseek(w->f, 0, SEEK_SET) != 0 || fwrite(&w->h, sizeof(w->h), 1, w->f) != 1)
+        w->failed = 1;
+    if (fclose(w->f) != 0) w->failed = 1;
+    int rc = w->failed ? -1 : 0;
+    if (rc != 0) fprintf(stderr, "%s: write failed\n", w->path);
+    free(w->shadow);
+    free(w->deltas);
+    free(w);
+    return rc;
+}
+
+/* ── Playback ────────────────────────────────────────────────────── */
+
+struct Replay {
+    void                     *base;
+    size_t                    len;
+    const RecHeader          *h;
+    MapDef                    map;
+    int                      *walls;
+    int                       total;
+    const unsigned long long *offsets;   /* byte offset of record i (state after i steps) */
+    int                       key_every;
+    unsigned char            *keys;      /* keyframe k = cells after record k * key_every */
+    int                       pos;       /* record the caller's AlgoVis is at, -1 = none */
+};
+
+static const RecStep *rec_at(const Replay *r, int i) {
+    return (const RecStep *)((const char *)r->base + r->offsets[i]);
+}
+
+static const unsigned *rec_deltas(const RecStep *s) {
+    return (const unsigned *)(s + 1);
+}
+
+Replay *replay_open(const char *path) {
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        perror(path);
+        return NULL;
+    }
+    struct stat st;
+    if (fstat(fd, &st) < 0) {
+        perror(path);
+        close(fd);
+        return NULL;
+    }
+    size_t len = (size_t)st.st_size;
+    if (len < sizeof(RecHeader)) {
+        fprintf(stderr, "%s: too short for a recording\n", path);
+        close(fd);
+        return NULL;
+    }
+    void *base = mmap(NULL, len, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED) {
+        perror(path);
+        return NULL;
+    }
+
+    const RecHeader *h = base;
+    long long total = (long long)h->rows * h->cols;
+    const char *err = NULL;
+    if (memcmp(h->magic, REC_MAGIC, 8) != 0)
+        err = "not a recording";
+    else if (h->version != REC_VERSION)
+        err = "unsupported recording version";
+    else if (h->byte_order != REC_BYTE_ORDER)
+        err = "written on a machine with different byte order";
+    else if (!memchr(h->alg, '\0', REC_NAME_LEN) || !memchr(h->map, '\0', REC_NAME_LEN))
+        err = "unterminated name";
+    else if (h->rows <= 0 || h->cols <= 0 || total > MAX_NODES)
+        err = "grid exceeds MAX_NODES; rebuild with -DMAX_ROWS=... -DMAX_COLS=...";
+    else if (h->start_r < 0 || h->start_r >= h->rows || h->start_c < 0 ||
+             h->start_c >= h->cols || h->end_r < 0 || h->end_r >= h->rows ||
+             h->end_c < 0 || h->end_c >= h->cols)
+        err = "start/end out of range";
+    else if (h->steps < 1 || sizeof(RecHeader) + snapshot_bytes(total) > len)
+        err = "truncated";
+    if (err) {
+        fprintf(stderr, "%s: %s\n", path, err);
+        munmap(base, len);
+        return NULL;
+    }
+
+    Replay *r = calloc(1, sizeof(*r));
+    r->base = base;
+    r->len = len;
+    r->h = h;
+    r->total = (int)total;
+    r->pos = -1;
+
+    /* Index records and build keyframes in one pass */
+    r->key_every = REC_MIN_KEY_EVERY;
+    /* Stop at one or two keyframes: a grid larger than the budget still
+     * needs its first snapshot, and doubling further would overflow */
+    while (r->key_every <= h->steps / 2 &&
+           (unsigned long long)(h->steps / r->key_every + 1) * total > REC_KEY_BUDGET)
+        r->key_every *= 2;
+    int nkeys = (h->steps - 1) / r->key_every + 1;
+    unsigned long long *offsets = malloc((size_t)h->steps * sizeof(*offsets));
+    r->offsets = offsets;
+    r->keys = malloc((size_t)nkeys * total);
+    unsigned char *cells = malloc(total);
+    memcpy(cells, (const char *)base + sizeof(RecHeader), total);
+
+    unsigned long long off = sizeof(RecHeader) + snapshot_bytes(total);
+    for (int i = 0; i < h->steps && !err; i++) {
+        if (off + sizeof(RecStep) > len) {
+            err = "truncated";
+            break;
+        }
+        offsets[i] = off;
+        const RecStep *s = rec_at(r, i);
+        off += sizeof(RecStep) + (unsigned long long)s->deltas * sizeof(unsigned);
+        if (off > len) {
+            err = "truncated";
+            break;
+        }
+        const unsigned *d = rec_deltas(s);
+        for (unsigned k = 0; k < s->deltas; k++) {
+            unsigned idx = d[k] >> REC_STATE_BITS;
+            if (idx >= (unsigned)total) {
+                err = "cell index out of range";
+                break;
+            }
+            cells[idx] = d[k] & ((1u << REC_STATE_BITS) - 1);
+        }
+        if (i % r->key_every == 0)
+            memcpy(r->keys + (size_t)(i / r->key_every) * total, cells, total);
+    }
+    free(cells);
+    if (err) {
+        fprintf(stderr, "%s: %s\n", path, err);
+        replay_close(r);
+        return NULL;
+    }
+
+    const unsigned char *init = (const unsigned char *)base + sizeof(RecHeader);
+    r->walls = malloc(total * sizeof(int));
+    for (long long i = 0; i < total; i++)
+        r->walls[i] = init[i] == VIS_WALL;
+    r->map.name = h->map;
+    r->map.rows = h->rows;
+    r->map.cols = h->cols;
+    r->map.start_r = h->start_r;
+    r->map.start_c = h->start_c;
+    r->map.end_r = h->end_r;
+    r->map.end_c = h->end_c;
+    r->map.data = r->walls;
+    return r;
+}
+
+void replay_close(Replay *r) {
+    if (!r) return;
+    munmap(r->base, r->len);
+    free((void *)r->offsets);
+    free(r->keys);
+    free(r->walls);
+    free(r);
+}
+
+const MapDef *replay_map(const Replay *r) { return &r->map; }
+const char *replay_alg(const Replay *r) { return r->h->alg; }
+int replay_steps(const Replay *r) { return r->h->steps - 1; }
+
+int replay_seek(Replay *r, int step, AlgoVis *vis) {
+    int last = r->h->steps - 1;
+    if (step < 0) step = 0;
+    if (step > last) step = last;
+
+    if (r->pos < 0 || step < r->pos || step - r->pos > r->key_every) {
+        int k = step / r->key_every;
+        memcpy(vis->cells, r->keys + (size_t)k * r->total, r->total);
+        vis->dirty_count = 0;
+        vis->dirty_all = 1;
+        r->pos = k * r->key_every;
+    }
+    while (r->pos < step) {
+        const RecStep *s = rec_at(r, ++r->pos);
+        const unsigned *d = rec_deltas(s);
+        for (unsigned k = 0; k < s->deltas; k++)
+            vis_set_cell(vis, d[k] >> REC_STATE_BITS, d[k] & ((1u << REC_STATE_BITS) - 1));
+    }
+
+    const RecStep *s = rec_at(r, step);
+    vis->rows = r->h->rows;
+    vis->cols = r->h->cols;
+    vis->start_node = get_index(vis->cols, r->h->start_r, r->h->start_c);
+    vis->end_node = get_index(vis->cols, r->h->end_r, r->h->end_c);
+    vis->steps = s->steps;
+    vis->nodes_explored = s->nodes_explored;
+    vis->relaxations = s->relaxations;
+    vis->path_len = s->path_len;
+    vis->path_cost = s->path_cost;
+    vis->done = (s->flags & REC_DONE) != 0;
+    vis->found = (s->flags & REC_FOUND) != 0;
+    vis->phase = (int)(s->flags >> REC_PHASE_SHIFT);
+    return step;
+}
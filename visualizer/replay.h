@@ -0,0 +1,86 @@
+/*
+ * replay.h — Record search runs and play them back
+ *
+ * A recording (.rrec) is the cell grid right after init() followed by one
+ * record for init and one per step() call: the AlgoVis counters at that
+ * point and the cells whose state changed. rrrlz-bench --record writes them headlessly;
+ * visualizer --replay plays them back at any speed and seeks to any step
+ * without running the plugin.
+ *
+ *   RecHeader | rows*cols bytes of cell state, padded to 4 | steps x
+ *   (RecStep, deltas)
+ *
+ * Each delta is one uint32: cell index << REC_STATE_BITS | new state.
+ * Integers are native-endian; byte_order catches a foreign file.
+ */
+
+#ifndef REPLAY_H
+#define REPLAY_H
+
+#include "algo.h"
+
+#define REC_MAGIC       "RRRLZREC"
+#define REC_VERSION     1
+#define REC_BYTE_ORDER  0x01020304u
+#define REC_STATE_BITS  4
+#define REC_NAME_LEN    48
+
+typedef struct {
+    char     magic[8];
+    unsigned version;
+    unsigned byte_order;
+    int      rows, cols;
+    int      start_r, start_c, end_r, end_c;
+    int      steps;                    /* RecStep records, the first for init */
+    char     alg[REC_NAME_LEN];        /* NUL-terminated */
+    char     map[REC_NAME_LEN];
+} RecHeader;
+
+/* Flags: bit 0 done, bit 1 found, bits 2.. current phase */
+#define REC_DONE   0x1u
+#define REC_FOUND  0x2u
+#define REC_PHASE_SHIFT 2
+
+typedef struct {
+    int      steps, nodes_explored, relaxations, path_len, path_cost;
+    unsigned flags;
+    unsigned deltas;                   /* uint32 deltas that follow */
+} RecStep;
+
+/* ── Writing ─────────────────────────────────────────────────────── */
+
+typedef struct RecWriter RecWriter;
+
+/* Start a recording of `vis` (just returned by init) on `map`; writes the
+ * grid and record 0. Returns NULL (after printing why) on error. */
+RecWriter *rec_open(const char *path, const char *alg_name, const MapDef *map,
+                    AlgoVis *vis);
+
+/* Append the state after one more step() call; consumes vis's change list */
+void rec_step(RecWriter *w, AlgoVis *vis);
+
+/* Finish the file; returns 0 on success */
+int rec_close(RecWriter *w);
+
+/* ── Playback ────────────────────────────────────────────────────── */
+
+typedef struct Replay Replay;
+
+/* Map a recording read-only and index it for seeking. Returns NULL (after
+ * printing why) on error or if the grid exceeds MAX_NODES. */
+Replay *replay_open(const char *path);
+
+void replay_close(Replay *r);
+
+/* Grid, start and end of the recorded run (walls only; no cost layer) */
+const MapDef *replay_map(const Replay *r);
+const char *replay_alg(const Replay *r);
+int replay_steps(const Replay *r);   /* step() calls recorded */
+
+/* Put `vis` in the state after `step` step() calls (0 = right after init).
+ * Moving forward applies deltas from the current position; moving back or
+ * far ahead restarts from the nearest keyframe. `vis` must not be
+ * modified between calls. Returns the step actually reached (clamped). */
+int replay_seek(Replay *r, int step, AlgoVis *vis);
+
+#endif /* REPLAY_H */
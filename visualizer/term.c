@@ -0,0 +1,464 @@
+/*
+ * rrrlz-term — Terminal front-end for the algorithm plugins
+ *
+ * Runs any plugin without SDL and animates the search in the terminal
+ * with ANSI colors, for inspecting searches over SSH on machines with no
+ * display. Two cells share a character: "▀" with the upper cell as the
+ * foreground and the lower one as the background color, so cells come out
+ * roughly square. Maps bigger than the terminal are shown in
+ * level-of-detail blocks (lod.h), the same way the visualizer zooms out.
+ *
+ * Frames are diffed: the cells on the plugin's change list update the
+ * block states, and only character cells whose colors changed are
+ * written, with a cursor move only where a run of changes breaks. Drawing
+ * is relative to the grid's top-left corner, so each run stays in the
+ * scrollback when the next one starts.
+ *
+ * Usage:
+ *   rrrlz-term [options] [algo ...]
+ *     --map NAME     Bundled map name prefix (default: the first map)
+ *     --map-file F   Load a .map / .rmap file instead
+ *     --gen SPEC     Generated map instead, KIND:SIZE[:seed=N][:p=F]
+ *     --delay MS     Pause between frames (default 30)
+ *     --steps N      step() calls per frame (default 1; 0 = final frame only)
+ *     --cols N       Terminal columns (default: the terminal's, else $COLUMNS)
+ *     --lines N      Terminal lines (default: the terminal's, else $LINES)
+ *     --ascii        One plain character per cell, no colors
+ *     algo           Algorithm name prefix (default all, one after another)
+ *
+ * Build:
+ *   just term
+ */
+
+#include <signal.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+
+#include "algo.h"
+#include "lod.h"
+#include "map_io.h"
+#include "mapgen.h"
+#include "plugins.h"
+#include "maps/maps.h"
+
+/* ── Options ─────────────────────────────────────────────────────── */
+
+static AlgoPlugin *algorithms[ALG_MAX];
+static int alg_count = 0;
+
+static const MapDef *map = NULL;
+static MapDef *loaded_map = NULL;   /* from --map-file / --gen, freed at exit */
+
+static int delay_ms = 30;
+static int steps_per_frame = 1;
+static int term_cols = 0, term_lines = 0;
+static int ascii = 0;
+
+static volatile sig_atomic_t stop = 0;
+
+static void on_sigint(int sig) {
+    (void)sig;
+    stop = 1;
+}
+
+/* ── Output buffer ───────────────────────────────────────────────── */
+
+/* A frame is built here and written with one fwrite */
+static char *out_buf = NULL;
+static size_t out_len = 0, out_cap = 0;
+static size_t out_total = 0;   /* bytes written for the current run */
+
+static void out_printf(const char *fmt, ...) {
+    for (;;) {
+        va_list ap;
+        va_start(ap, fmt);
+        int n = vsnprintf(out_buf + out_len, out_cap - out_len, fmt, ap);
+        va_end(ap);
+        if (n >= 0 && (size_t)n < out_cap - out_len) {
+            out_len += (size_t)n;
+            return;
+        }
+        out_cap = out_cap ? out_cap * 2 : 65536;
+        out_buf = realloc(out_buf, out_cap);
+    }
+}
+
+static void out_flush(void) {
+    fwrite(out_buf, 1, out_len, stdout);
+    fflush(stdout);
+    out_total += out_len;
+    out_len = 0;
+}
+
+/* ── Screen ──────────────────────────────────────────────────────── */
+
+/* Same palette as the visualizer */
+static const uint8_t cell_rgb[LOD_STATES][3] = {
+    [VIS_EMPTY]      = {200, 200, 200},
+    [VIS_WALL]       = {60,  60,  70},
+    [VIS_OPEN]       = {100, 180, 255},
+    [VIS_CLOSED]     = {255, 160, 80},
+    [VIS_PATH]       = {50,  230, 100},
+    [VIS_START]      = {255, 255, 60},
+    [VIS_END]        = {230, 50,  50},
+    [VIS_PREPROCESS] = {60,  120, 120},
+};
+
+/* --ascii characters, as printed by the standalone programs */
+static const char cell_char[LOD_STATES] = {
+    [VIS_EMPTY] = '.', [VIS_WALL] = '#', [VIS_OPEN] = 'o', [VIS_CLOSED] = 'x',
+    [VIS_PATH] = '*', [VIS_START] = 'S', [VIS_END] = 'E', [VIS_PREPROCESS] = '~',
+};
+
+#define NO_CELL   0xFF      /* below the last block row */
+#define UNDRAWN   0xFFFF    /* never a real top/bottom pair */
+
+/* The screen shows `lod` in rows x cols character cells (two block rows
+ * per character unless --ascii). `seen` holds the cell states lod was
+ * built from, `shown` what each character cell currently displays. */
+static Lod lod;
+static uint8_t *seen = NULL;
+static uint16_t *shown = NULL;
+static uint8_t *pending = NULL;    /* character cell is on `changed` */
+static int *changed = NULL;
+static int changed_count = 0;
+static int scr_rows = 0, scr_cols = 0;
+static int cur_row = 0, cur_col = 0;   /* cursor, relative to the grid */
+static int cur_fg = -1, cur_bg = -1;
+
+static void terminal_size(void) {
+    struct winsize ws;
+    int cols = 0, lines = 0;
+    if (ioctl(STDOUT_FILENO, TIOCGWINSZ, &ws) == 0) {
+        cols = ws.ws_col;
+        lines = ws.ws_row;
+    }
+    if (cols <= 0 && getenv("COLUMNS")) cols = atoi(getenv("COLUMNS"));
+    if (lines <= 0 && getenv("LINES")) lines = atoi(getenv("LINES"));
+    if (term_cols <= 0) term_cols = cols > 0 ? cols : 80;
+    if (term_lines <= 0) term_lines = lines > 0 ? lines : 24;
+}
+
+/* Smallest power-of-two block that fits the grid, a header line and the
+ * status line into the terminal */
+static int fit_block(int rows, int cols) {
+    int avail = term_lines - 3;
+    if (avail < 1) avail = 1;
+    int per_line = ascii ? 1 : 2;
+    int block = 1;
+    while (block < LOD_MAX_BLOCK &&
+           ((cols + block - 1) / block > term_cols ||
+            ((rows + block - 1) / block + per_line - 1) / per_line > avail))
+        block *= 2;
+    return block;
+}
+
+static void move_to(int row, int col) {
+    if (row == cur_row && col == cur_col) return;
+    if (row > cur_row) out_printf("\033[%dB", row - cur_row);
+    else if (row < cur_row) out_printf("\033[%dA", cur_row - row);
+    if (col != cur_col) {
+        out_printf("\r");
+        if (col > 0) out_printf("\033[%dC", col);
+    }
+    cur_row = row;
+    cur_col = col;
+}
+
+static void set_color(int fg, int bg) {
+    if (fg != cur_fg) {
+        out_printf("\033[38;2;%d;%d;%dm", cell_rgb[fg][0], cell_rgb[fg][1], cell_rgb[fg][2]);
+        cur_fg = fg;
+    }
+    if (bg != cur_bg) {
+        if (bg == NO_CELL)
+            out_printf("\033[49m");
+        else
+            out_printf("\033[48;2;%d;%d;%dm", cell_rgb[bg][0], cell_rgb[bg][1], cell_rgb[bg][2]);
+        cur_bg = bg;
+    }
+}
+
+/* What character cell k should show: top << 8 | bottom block state */
+static uint16_t cell_key(int k) {
+    int r = k / scr_cols, c = k % scr_cols;
+    if (ascii) return lod.state[r * lod.bcols + c];
+    int top = lod.state[2 * r * lod.bcols + c];
+    int bot = 2 * r + 1 < lod.brows ? lod.state[(2 * r + 1) * lod.bcols + c] : NO_CELL;
+    return (uint16_t)(top << 8 | bot);
+}
+
+static void draw_cell(int k) {
+    uint16_t key = cell_key(k);
+    if (key == shown[k]) return;
+    shown[k] = key;
+    move_to(k / scr_cols, k % scr_cols);
+    if (ascii) {
+        out_printf("%c", cell_char[key]);
+    } else {
+        set_color(key >> 8, key & 0xFF);
+        out_printf("\xe2\x96\x80");   /* ▀ */
+    }
+    cur_col++;
+}
+
+static void mark_block(int b) {
+    int r = b / lod.bcols, c = b % lod.bcols;
+    int k = (ascii ? r : r / 2) * scr_cols + c;
+    if (pending[k]) return;
+    pending[k] = 1;
+    changed[changed_count++] = k;
+}
+
+static int cmp_int(const void *a, const void *b) {
+    return *(const int *)a - *(const int *)b;
+}
+
+static void screen_free(void) {
+    if (lod.state) lod_free(&lod);
+    free(seen);
+    free(shown);
+    free(pending);
+    free(changed);
+    seen = NULL;
+    shown = NULL;
+    pending = NULL;
+    changed = NULL;
+}
+
+/* Size the screen for vis's map and reserve its lines below the header */
+static void screen_begin(const AlgoVis *vis) {
+    int n = vis->rows * vis->cols;
+    screen_free();
+    seen = malloc(n);
+    memcpy(seen, vis->cells, n);
+    lod_build(&lod, seen, vis->rows, vis->cols, fit_block(vis->rows, vis->cols));
+
+    scr_cols = lod.bcols;
+    scr_rows = ascii ? lod.brows : (lod.brows + 1) / 2;
+    shown = malloc((size_t)scr_rows * scr_cols * sizeof(uint16_t));
+    for (int k = 0; k < scr_rows * scr_cols; k++)
+        shown[k] = UNDRAWN;
+    pending = calloc((size_t)scr_rows * scr_cols, 1);
+    changed = malloc((size_t)scr_rows * scr_cols * sizeof(int));
+    changed_count = 0;
+
+    /* Grid lines plus the status line, then back up to the grid's corner */
+    for (int r = 0; r <= scr_rows; r++)
+        out_printf("\n");
+    out_printf("\033[%dA\r", scr_rows + 1);
+    cur_row = cur_col = 0;
+    cur_fg = cur_bg = -1;
+}
+
+/* Bring the screen up to date with vis and consume its change list */
+static void draw_frame(AlgoVis *vis) {
+    int total = scr_rows * scr_cols;
+    if (vis->dirty_all) {
+        int n = vis->rows * vis->cols;
+        int block = lod.block;
+        memcpy(seen, vis->cells, n);
+        lod_free(&lod);
+        lod_build(&lod, seen, vis->rows, vis->cols, block);
+        for (int k = 0; k < total; k++)
+            draw_cell(k);
+    } else {
+        for (int d = 0; d < vis->dirty_count; d++) {
+            int idx = vis->dirty[d];
+            if (seen[idx] == vis->cells[idx]) continue;
+            int b = lod_update(&lod, idx, seen[idx], vis->cells[idx]);
+            seen[idx] = vis->cells[idx];
+            if (b >= 0) mark_block(b);
+        }
+        /* Row-major order keeps changed runs contiguous */
+        qsort(changed, changed_count, sizeof(int), cmp_int);
+        for (int i = 0; i < changed_count; i++) {
+            pending[changed[i]] = 0;
+            draw_cell(changed[i]);
+        }
+    }
+    changed_count = 0;
+    vis_clear_dirty(vis);
+}
+
+/* The status line is cut to the terminal width: a wrapped line would
+ * throw off the relative cursor moves */
+static void draw_status(const AlgoVis *vis, const char *alg, double total_us) {
+    const char *status = vis->done ? (vis->found ? "FOUND" : "NO PATH") : "searching";
+    char line[256], path[48] = "";
+    if (vis->found)
+        snprintf(path, sizeof(path), "  path %d (%d nodes)", vis->path_cost, vis->path_len);
+    snprintf(line, sizeof(line), "  %s: %s  steps %d  explored %d  relax %d%s  %.1fus  out %.1f KB",
+             alg, status, vis->steps, vis->nodes_explored, vis->relaxations, path,
+             total_us, (out_total + out_len) / 1024.0);
+
+    move_to(scr_rows, 0);
+    if (!ascii) {
+        out_printf("\033[0m");
+        cur_fg = cur_bg = -1;
+    }
+    out_printf("\033[K%.*s\r", term_cols - 1, line);
+}
+
+/* ── Runs ────────────────────────────────────────────────────────── */
+
+static void run_one(AlgoPlugin *p) {
+    if (p->max_nodes > 0 && map->rows * map->cols > p->max_nodes) {
+        printf("%s on %s (%dx%d): SKIPPED (too large)\n", p->name, map->name,
+               map->cols, map->rows);
+        return;
+    }
+
+    AlgoVis *vis = p->init(map);
+    out_total = 0;
+    out_printf("%s on %s (%dx%d", p->name, map->name, map->cols, map->rows);
+    int block = fit_block(map->rows, map->cols);
+    if (block > 1) out_printf(", %dx%d cells per block", block, block);
+    out_printf(")\n");
+    screen_begin(vis);
+    if (!ascii) out_printf("\033[?25l");   /* hide the cursor while drawing */
+
+    double total_us = 0.0;
+    int more = 1;
+    while (more && !stop) {
+        double t0 = vis_clock_us();
+        if (steps_per_frame > 0)
+            for (int n = 0; n < steps_per_frame && more; n++) more = p->step(vis);
+        else
+            while ((more = p->step(vis))) {}
+        total_us += vis_clock_us() - t0;
+
+        draw_frame(vis);
+        draw_status(vis, p->name, total_us);
+        out_flush();
+        if (more && delay_ms > 0) usleep((useconds_t)delay_ms * 1000);
+    }
+
+    /* Leave the final frame in the scrollback */
+    move_to(scr_rows, 0);
+    out_printf("\n");
+    if (!ascii) out_printf("\033[0m\033[?25h");
+    out_flush();
+}
+
+/* ── Main ────────────────────────────────────────────────────────── */
+
+static void usage(void) {
+    printf("Usage: rrrlz-term [options] [algo ...]\n");
+    printf("  --map NAME     Bundled map name prefix (default: first map)\n");
+    printf("  --map-file F   Load a .map / .rmap file\n");
+    printf("  --gen SPEC     Generated map, KIND:SIZE[:seed=N][:p=F] (SIZE = WxH or cells)\n");
+    printf("                 KIND: random maze rooms cave spiral\n");
+    printf("  --delay MS     Pause between frames (default 30)\n");
+    printf("  --steps N      step() calls per frame (default 1; 0 = final frame only)\n");
+    printf("  --cols N       Terminal columns (default: detected)\n");
+    printf("  --lines N      Terminal lines (default: detected)\n");
+    printf("  --ascii        Plain characters, no colors\n");
+    printf("  algo           Algorithm name prefix (case-insensitive). Available:\n           ");
+    for (int i = 0; i < ALG_MAX; i++)
+        printf(" %s", all_algorithms[i]->name);
+    printf("\n  Maps:\n           ");
+    for (int i = 0; i < MAP_COUNT; i++)
+        printf(" \"%s\"", all_maps[i]->name);
+    printf("\n");
+}
+
+static const char *need_arg(int argc, char *argv[], int *a) {
+    if (*a + 1 >= argc) {
+        fprintf(stderr, "%s: missing argument\n", argv[*a]);
+        exit(2);
+    }
+    return argv[++*a];
+}
+
+/* --gen KIND:SIZE[:seed=N][:p=F], the bench's grammar with one size */
+static MapDef *gen_map(const char *spec) {
+    MapGenSpec gs;
+    if (mapgen_parse_spec(spec, 1, &gs) != 0) return NULL;
+    if (gs.count != 1) {
+        fprintf(stderr, "--gen: rrrlz-term shows one map, got %d sizes\n", gs.count);
+        return NULL;
+    }
+    return mapgen_generate(gs.kind, gs.rows[0], gs.cols[0], gs.seed, gs.density);
+}
+
+static void parse_args(int argc, char *argv[]) {
+    for (int a = 1; a < argc; a++) {
+        const char *arg = argv[a];
+
+        if (strcmp(arg, "--help") == 0 || strcmp(arg, "-h") == 0) {
+            usage();
+            exit(0);
+        }
+        if (strcmp(arg, "--delay") == 0) { delay_ms = atoi(need_arg(argc, argv, &a)); continue; }
+        if (strcmp(arg, "--steps") == 0) { steps_per_frame = atoi(need_arg(argc, argv, &a)); continue; }
+        if (strcmp(arg, "--cols") == 0)  { term_cols = atoi(need_arg(argc, argv, &a)); continue; }
+        if (strcmp(arg, "--lines") == 0) { term_lines = atoi(need_arg(argc, argv, &a)); continue; }
+        if (strcmp(arg, "--ascii") == 0) { ascii = 1; continue; }
+        int is_gen = strcmp(arg, "--gen") == 0;
+        if (is_gen || strcmp(arg, "--map-file") == 0) {
+            const char *val = need_arg(argc, argv, &a);
+            map_free(loaded_map);
+            loaded_map = is_gen ? gen_map(val) : map_load_file(val);
+            if (!loaded_map || !map_fits(loaded_map)) exit(2);
+            map = loaded_map;
+            continue;
+        }
+        if (strcmp(arg, "--map") == 0) {
+            const char *name = need_arg(argc, argv, &a);
+            map = NULL;
+            for (int i = 0; i < MAP_COUNT && !map; i++)
+                if (name_prefix_match(name, all_maps[i]->name)) map = all_maps[i];
+            if (!map) {
+                fprintf(stderr, "unknown map: %s\n", name);
+                exit(2);
+            }
+            continue;
+        }
+        if (arg[0] == '-') {
+            fprintf(stderr, "unknown option: %s (see --help)\n", arg);
+            exit(2);
+        }
+
+        int matched = 0;
+        for (int i = 0; i < ALG_MAX; i++) {
+            if (!name_prefix_match(arg, all_algorithms[i]->name)) continue;
+            matched = 1;
+            int dup = 0;
+            for (int j = 0; j < alg_count; j++)
+                if (algorithms[j] == all_algorithms[i]) dup = 1;
+            if (!dup) algorithms[alg_count++] = all_algorithms[i];
+        }
+        if (!matched) {
+            fprintf(stderr, "unknown algorithm: %s\n", arg);
+            exit(2);
+        }
+    }
+
+    if (!map) map = all_maps[0];
+    if (alg_count == 0) {
+        for (int i = 0; i < ALG_MAX; i++)
+            algorithms[i] = all_algorithms[i];
+        alg_count = ALG_MAX;
+    }
+    if (delay_ms < 0) delay_ms = 0;
+    if (steps_per_frame < 0) steps_per_frame = 0;
+}
+
+int main(int argc, char *argv[]) {
+    parse_args(argc, argv);
+    terminal_size();
+    signal(SIGINT, on_sigint);
+
+    for (int i = 0; i < alg_count && !stop; i++)
+        run_one(algorithms[i]);
+
+    screen_free();
+    free(out_buf);
+    map_free(loaded_map);
+    return stop ? 130 : 0;
+}
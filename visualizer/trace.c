@@ -0,0 +1,139 @@
+/*
+ * trace.c — Trace ring buffer and Chrome trace export
+ */
+
+#include <stdio.h>
+
+#include "algo.h"
+#include "trace.h"
+
+void json_write_string(FILE *f, const char *s) {
+    fputc('"', f);
+    for (; *s; s++) {
+        unsigned char ch = (unsigned char)*s;
+        if (ch == '"' || ch == '\\') fprintf(f, "\\%c", ch);
+        else if (ch < 0x20)        fprintf(f, "\\u%04x", ch);
+        else                       fputc(ch, f);
+    }
+    fputc('"', f);
+}
+
+#ifdef RRRLZ_TRACE
+
+TraceEvent trace_buf[TRACE_CAP];
+_Atomic uint64_t trace_head;
+
+#define TRACE_MAX_LABELS 4096
+
+static char *labels[TRACE_MAX_LABELS];
+static int label_count = 0;
+
+void trace_run(const char *label) {
+    if (label_count == 0 || strcmp(labels[label_count - 1], label) != 0) {
+        if (label_count == TRACE_MAX_LABELS) {
+            /* Table full: reuse the last slot rather than drop the run */
+            free(labels[--label_count]);
+        }
+        labels[label_count++] = strdup(label);
+    }
+    trace_emit(TRACE_RUN, label_count - 1, 0, 0);
+}
+
+void trace_reset(void) {
+    atomic_store(&trace_head, 0);
+    for (int i = 0; i < label_count; i++)
+        free(labels[i]);
+    label_count = 0;
+}
+
+/* Start the next JSON array element */
+static void next_event(FILE *f, long *written) {
+    if ((*written)++) fprintf(f, ",\n");
+}
+
+/* Run labels carry map names, which may hold quotes or backslashes */
+static void slice_begin(FILE *f, long *written, const char *name, double ts) {
+    next_event(f, written);
+    fprintf(f, "{\"name\": ");
+    json_write_string(f, name);
+    fprintf(f, ", \"ph\": \"B\", \"ts\": %.3f, \"pid\": 1, \"tid\": 1}", ts);
+}
+
+static void slice_end(FILE *f, long *written, double ts) {
+    next_event(f, written);
+    fprintf(f, "{\"ph\": \"E\", \"ts\": %.3f, \"pid\": 1, \"tid\": 1}", ts);
+}
+
+/* Runs and phases become nested duration slices, expansions and
+ * relaxations instant events, heap operations a "heap" size counter.
+ * Call it while no thread is writing. */
+long trace_write_chrome(const char *path) {
+    FILE *f = strcmp(path, "-") == 0 ? stdout : fopen(path, "w");
+    if (!f) {
+        perror(path);
+        return -1;
+    }
+    uint64_t head = atomic_load(&trace_head);
+    uint64_t first = head > TRACE_CAP ? head - TRACE_CAP : 0;
+    uint64_t t0 = first < head ? trace_buf[first & (TRACE_CAP - 1)].ts_ns : 0;
+    double ts = 0.0;
+    int run_open = 0, phase_open = 0;
+    long written = 0;
+
+    fprintf(f, "{\"displayTimeUnit\": \"ns\", \"traceEvents\": [\n");
+    for (uint64_t i = first; i < head; i++) {
+        const TraceEvent *e = &trace_buf[i & (TRACE_CAP - 1)];
+        ts = (double)(e->ts_ns - t0) / 1e3;
+        switch (e->kind) {
+        case TRACE_RUN:
+            if (phase_open) slice_end(f, &written, ts);
+            if (run_open) slice_end(f, &written, ts);
+            phase_open = 0;
+            run_open = e->node >= 0 && e->node < label_count;
+            if (run_open) slice_begin(f, &written, labels[e->node], ts);
+            break;
+        case TRACE_PHASE:
+            if (phase_open) slice_end(f, &written, ts);
+            phase_open = e->value >= 0 && e->value < PHASE_COUNT;
+            if (phase_open) slice_begin(f, &written, phase_names[e->value], ts);
+            break;
+        case TRACE_EXPAND:
+            next_event(f, &written);
+            fprintf(f, "{\"name\": \"expand\", \"ph\": \"i\", \"s\": \"t\", "
+                       "\"ts\": %.3f, \"pid\": 1, \"tid\": 1, \"args\": {\"node\": %d}}",
+                    ts, e->node);
+            break;
+        case TRACE_RELAX:
+            next_event(f, &written);
+            fprintf(f, "{\"name\": \"relax\", \"ph\": \"i\", \"s\": \"t\", "
+                       "\"ts\": %.3f, \"pid\": 1, \"tid\": 1, "
+                       "\"args\": {\"node\": %d, \"cost\": %d}}",
+                    ts, e->node, e->value);
+            break;
+        case TRACE_HEAP_PUSH:
+        case TRACE_HEAP_POP:
+            next_event(f, &written);
+            fprintf(f, "{\"name\": \"heap\", \"ph\": \"C\", \"ts\": %.3f, "
+                       "\"pid\": 1, \"tid\": 1, \"args\": {\"size\": %d}}",
+                    ts, e->aux);
+            break;
+        }
+    }
+    if (phase_open) slice_end(f, &written, ts);
+    if (run_open) slice_end(f, &written, ts);
+    fprintf(f, "\n]}\n");
+    if (f != stdout) fclose(f);
+    return written;
+}
+
+#else /* !RRRLZ_TRACE */
+
+long trace_write_chrome(const char *path) {
+    (void)path;
+    fprintf(stderr, "trace: built without -DRRRLZ_TRACE\n");
+    return -1;
+}
+
+void trace_reset(void) {}
+
+#endif /* RRRLZ_TRACE */
@@ -0,0 +1,101 @@
+/*
+ * trace.h — Compile-time event trace of search internals
+ *
+ * Build with -DRRRLZ_TRACE to record node expansions, edge relaxations,
+ * heap pushes/pops and phase changes into a fixed ring buffer with
+ * nanosecond timestamps. Writers claim slots with one relaxed atomic
+ * fetch-add, so the buffer is lock-free and safe for several threads;
+ * when it wraps, the oldest events are overwritten. trace_write_chrome()
+ * exports what the ring holds as Chrome trace JSON, which loads in
+ * chrome://tracing and ui.perfetto.dev.
+ *
+ * Without RRRLZ_TRACE every TRACE_* macro expands to nothing, so plugins
+ * pay nothing for the hooks. The expand, relax and push hooks also feed
+ * the per-cell counters of heat.h when built with -DRRRLZ_HEAT.
+ */
+
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <stdio.h>
+
+#include "heat.h"
+
+#ifdef RRRLZ_TRACE
+
+#include <stdatomic.h>
+#include <stdint.h>
+#include <time.h>
+
+/* Ring capacity in events (power of two); 1M events = 24 MB */
+#ifndef TRACE_CAP
+#define TRACE_CAP (1u << 20)
+#endif
+
+enum TraceKind {
+    TRACE_RUN,          /* node = label id from trace_run() */
+    TRACE_PHASE,        /* value = enum AlgoPhase entered */
+    TRACE_EXPAND,       /* node expanded / closed */
+    TRACE_RELAX,        /* node's cost improved to value */
+    TRACE_HEAP_PUSH,    /* value = priority, aux = heap size after */
+    TRACE_HEAP_POP,
+};
+
+typedef struct {
+    uint64_t ts_ns;
+    int32_t  node;
+    int32_t  value;
+    int32_t  aux;
+    uint32_t kind;
+} TraceEvent;
+
+extern TraceEvent trace_buf[TRACE_CAP];
+extern _Atomic uint64_t trace_head;
+
+static inline void trace_emit(uint32_t kind, int node, int value, int aux) {
+    uint64_t i = atomic_fetch_add_explicit(&trace_head, 1, memory_order_relaxed);
+    TraceEvent *e = &trace_buf[i & (TRACE_CAP - 1)];
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    e->ts_ns = (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+    e->node = node;
+    e->value = value;
+    e->aux = aux;
+    e->kind = kind;
+}
+
+/* Start a new top-level slice named `label` (copied; consecutive runs with
+ * the same label share one copy) */
+void trace_run(const char *label);
+
+#define TRACE_EMIT(kind, node, value, aux) trace_emit((kind), (node), (value), (aux))
+#define TRACE_RUN(label)              trace_run(label)
+
+#else /* !RRRLZ_TRACE */
+
+#define TRACE_EMIT(kind, node, value, aux) ((void)0)
+#define TRACE_RUN(label)              ((void)0)
+
+#endif /* RRRLZ_TRACE */
+
+#define TRACE_PHASE(phase)            TRACE_EMIT(TRACE_PHASE, -1, (phase), 0)
+#define TRACE_EXPAND(node)            (TRACE_EMIT(TRACE_EXPAND, (node), 0, 0), \
+                                       HEAT_COUNT(HEAT_EXPAND, (node)))
+#define TRACE_RELAX(node, cost)       (TRACE_EMIT(TRACE_RELAX, (node), (cost), 0), \
+                                       HEAT_COUNT(HEAT_RELAX, (node)))
+#define TRACE_HEAP_PUSH(node, prio, size) TRACE_EMIT(TRACE_HEAP_PUSH, (node), (prio), (size))
+#define TRACE_HEAP_POP(node, prio, size)  TRACE_EMIT(TRACE_HEAP_POP, (node), (prio), (size))
+
+/* Write the buffered events as Chrome trace JSON ("-" = stdout). Returns
+ * the number of events written, or -1 on error or when built without
+ * RRRLZ_TRACE. */
+long trace_write_chrome(const char *path);
+
+/* Drop all buffered events */
+void trace_reset(void);
+
+/* Write `s` as a quoted JSON string, escaping quotes, backslashes and
+ * control characters (available with or without RRRLZ_TRACE) */
+void json_write_string(FILE *f, const char *s);
+
+#endif /* TRACE_H */
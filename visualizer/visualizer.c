@@ -13,59 +13,98 @@
  *   7-9, 0      Fringe, Flow Fields, D* Lite, Theta*
  *   F1-F4       RSR, Subgoal Graphs, CH, BiDir-A*
  *   Tab         Cycle maps
- *   +/-         Speed up / slow down animation
+ *   +/-         Speed up / slow down animation (speed 0 = as fast as frames allow)
+ *   Wheel/drag  Zoom at the cursor / pan      Z  Fit the whole map
+ *   H           Heat overlay: off, expand, relax, push, los (-DRRRLZ_HEAT)
  *   Q / Escape  Quit
  *
+ * Replay (visualizer --replay FILE.rrec, recorded by rrrlz-bench --record):
+ *   Space/Right Step forward          Left/Backspace  Step back
+ *   Enter       Play / pause          [ / ]           Halve / double steps per tick
+ *   Home/End    First / last step     PgUp/PgDn       Back / forward 10%
+ *   0-9         Seek to 0%..90%
+ *
+ * Race (visualizer --race ALGO ALGO [ALGO [ALGO]] [--pace step|time]):
+ *   Space       Step every lane once  Enter  Auto-run all lanes
+ *   P           Toggle step / wall-clock pacing
+ *
  * Build:
  *   just visualizer
+ *   just vis_flags=-DRRRLZ_HEAT visualizer    (with the heat overlay)
  */
 
 #include <SDL2/SDL.h>
+#include <stdarg.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
 #include "algo.h"
+#include "heat.h"
+#include "lod.h"
+#include "map_info.h"
+#include "plugins.h"
+#include "replay.h"
 #include "maps/maps.h"
 
 /* ── Map state ────────────────────────────────────────────────────── */
 
 static int current_map = 0;
 
-/* ── Algorithm plugins ───────────────────────────────────────────── */
+/* ── Replay ──────────────────────────────────────────────────────── */
+
+/* In replay mode the recording stands in for both the map and the only
+ * algorithm: its step() advances the playback instead of searching. */
+static Replay *replay = NULL;
+static AlgoVis replay_vis;
+static int replay_pos = 0;
+static int replay_stride = 1;   /* recorded steps per step() */
+
+static AlgoVis *replay_init(const MapDef *map) {
+    (void)map;
+    replay_pos = replay_seek(replay, 0, &replay_vis);
+    return &replay_vis;
+}
+
+static int replay_step(AlgoVis *vis) {
+    replay_pos = replay_seek(replay, replay_pos + replay_stride, vis);
+    return replay_pos < replay_steps(replay);
+}
+
+static void replay_goto(int step) {
+    replay_pos = replay_seek(replay, step, &replay_vis);
+}
 
-extern AlgoPlugin algo_dijkstra;
-extern AlgoPlugin algo_astar;
-extern AlgoPlugin algo_bellman_ford;
-extern AlgoPlugin algo_ida_star;
-extern AlgoPlugin algo_floyd_warshall;
-extern AlgoPlugin algo_jps;
-extern AlgoPlugin algo_fringe;
-extern AlgoPlugin algo_flowfield;
-extern AlgoPlugin algo_dstar_lite;
-extern AlgoPlugin algo_theta;
-extern AlgoPlugin algo_rsr;
-extern AlgoPlugin algo_subgoal;
-extern AlgoPlugin algo_ch;
-extern AlgoPlugin algo_anya;
-
-#define ALG_MAX 14
-
-/* Master list of all algorithms */
-static AlgoPlugin *all_algorithms[ALG_MAX] = {
-    &algo_dijkstra, &algo_astar, &algo_bellman_ford,
-    &algo_ida_star, &algo_floyd_warshall, &algo_jps,
-    &algo_fringe, &algo_flowfield, &algo_dstar_lite,
-    &algo_theta, &algo_rsr, &algo_subgoal,
-    &algo_ch, &algo_anya,
+static AlgoPlugin replay_plugin = {
+    .init = replay_init,
+    .step = replay_step,
 };
 
+static const MapDef *cur_map(void) {
+    return replay ? replay_map(replay) : all_maps[current_map];
+}
+
+/* Open cells, components and bounds of each map (the last slot is the
+ * replay's), computed the first time the map is shown */
+static MapInfo map_infos[MAP_COUNT + 1];
+static int map_info_ready[MAP_COUNT + 1];
+
+static const MapInfo *cur_info(void) {
+    int k = replay ? MAP_COUNT : current_map;
+    if (!map_info_ready[k]) {
+        map_info_compute(cur_map(), &map_infos[k]);
+        map_info_ready[k] = 1;
+    }
+    return &map_infos[k];
+}
+
+/* ── Algorithm plugins ───────────────────────────────────────────── */
+
 /* Active (filtered) list — populated from CLI or defaults to all */
 static AlgoPlugin *algorithms[ALG_MAX];
 static int alg_count = 0;
 
 static int current_alg = 0;
-static AlgoVis *vis = NULL;
 
 /* Per-algorithm info bar colors (indexed by master list position) */
 static const SDL_Color all_alg_colors[ALG_MAX] = {
@@ -88,65 +127,388 @@ static const SDL_Color all_alg_colors[ALG_MAX] = {
 /* Active color list, built alongside algorithms[] */
 static SDL_Color alg_colors[ALG_MAX];
 
+/* ── Lanes ───────────────────────────────────────────────────────── */
+
+/* A lane is one search on the current map: the plugin's state, its timing,
+ * an optional worker thread and the texture its panel is drawn from. The
+ * normal view has one lane; --race runs up to LANE_MAX side by side. Each
+ * plugin keeps its state in its own globals, so the lanes of a race must
+ * run distinct plugins (select_algorithms() drops duplicates). */
+#define LANE_MAX 4
+
+typedef struct {
+    int          alg;          /* index into algorithms[] */
+    AlgoVis     *vis;          /* plugin state; owned by the worker while it runs */
+    int          calls;        /* step() calls since init */
+    double       step_us, total_us;
+
+    /* With a worker, the renderer and stats read `view`, a snapshot the
+     * worker refreshes from vis's change list under `lock`, and never touch
+     * state the search is writing. Without a worker, view is vis itself. */
+    AlgoVis     *view;
+    AlgoVis     *snap;
+    int          view_calls;
+    double       view_step_us, view_total_us;
+    SDL_mutex   *lock;
+    SDL_Thread  *worker;
+    SDL_atomic_t quit;
+    SDL_atomic_t step_ms;
+
+    /* Grid texture and what it shows, see render_grid() */
+    SDL_Texture *tex;
+    Uint32      *px;
+    uint8_t     *seen;
+    Lod          lod;
+    int          stale;
+
+    /* Heat overlay (-DRRRLZ_HEAT): `heat` is counted by the thread that
+     * steps the lane; publish() copies the shown kind to heat_view, with
+     * its max, hottest cell and total, for the UI to read */
+    HeatMap      heat;
+    uint32_t    *heat_view;
+    uint32_t     heat_max;
+    int          heat_hot;
+    long long    heat_total;
+    int          heat_calls;   /* `calls` at the last copy, -1 = copy now */
+    Uint32       heat_copied;  /* ticks at the last copy */
+    int          heat_fresh;   /* heat_view changed since heat_tex was built */
+    SDL_Texture *heat_tex;
+    Uint32      *heat_px;
+} Lane;
+
+static Lane lanes[LANE_MAX];
+static int lane_count = 1;
+
+/* Race pacing. PACE_STEP keeps the lanes at the same number of step()
+ * calls: workers stop at race_target, which the UI moves on. PACE_TIME
+ * lets every worker run freely, so lanes get the same wall-clock time. */
+enum { PACE_STEP, PACE_TIME };
+
+static int race = 0;
+static int race_pace = PACE_STEP;
+static SDL_atomic_t race_target;
+
+/* Shown heat kind (enum HeatKind), -1 = off */
+static int heat_kind = -1;
+
+static void lane_lock(Lane *l)   { if (l->lock) SDL_LockMutex(l->lock); }
+static void lane_unlock(Lane *l) { if (l->lock) SDL_UnlockMutex(l->lock); }
+
+/* Over the plugin's node cap: init'ed on the map but never searched */
+static int lane_skipped(const Lane *l) {
+    const MapDef *m = cur_map();
+    return algorithms[l->alg]->max_nodes > 0 &&
+           m->rows * m->cols > algorithms[l->alg]->max_nodes;
+}
+
 /* ── Dynamic rendering ───────────────────────────────────────────── */
 
 #define INFO_H    60
-#define GRID_PAD  1
-#define MIN_CELL  4
-#define MAX_CELL  32
+#define MAX_CELL  32    /* largest fitted cell, px */
+#define MAX_ZOOM  64.0  /* largest zoomed-in cell, px */
 #define MAX_WIN   800
+#define RACE_WIN  600   /* fitted panel size in race mode */
+#define PANEL_GAP 4
 
-static int cell_size = 32;
 static SDL_Window *win = NULL;
 static SDL_Renderer *ren = NULL;
 
-static int win_w(void) { return all_maps[current_map]->cols * cell_size; }
-static int win_h(void) { return all_maps[current_map]->rows * cell_size + INFO_H; }
+/* Viewport: the grid area is view_w x view_h px and shows the map from
+ * cell (view_x, view_y) at zoom px per cell. fit_zoom shows the whole map;
+ * below 1 px per cell the renderer switches to level-of-detail blocks.
+ * In a race every panel shows the same viewport. */
+static int view_w = 0, view_h = 0;
+static double fit_zoom = 1.0, zoom = 1.0;
+static double view_x = 0.0, view_y = 0.0;
+
+/* Panels (grid plus info bar) sit side by side for two lanes, 2x2 above */
+static int panel_cols(void) { return lane_count > 2 ? 2 : lane_count; }
+static int panel_rows(void) { return lane_count > 2 ? 2 : 1; }
+
+static int win_w(void) { return panel_cols() * (view_w + PANEL_GAP) - PANEL_GAP; }
+static int win_h(void) { return panel_rows() * (view_h + INFO_H); }
+
+static SDL_Rect panel_rect(int lane) {
+    SDL_Rect r = {(lane % panel_cols()) * (view_w + PANEL_GAP),
+                  (lane / panel_cols()) * (view_h + INFO_H), view_w, view_h + INFO_H};
+    return r;
+}
+
+/* Lane whose panel holds window pixel (*x, *y), which is made relative to
+ * the panel; -1 if none */
+static int panel_at(int *x, int *y) {
+    int c = *x / (view_w + PANEL_GAP), r = *y / (view_h + INFO_H);
+    int lane = r * panel_cols() + c;
+    *x -= c * (view_w + PANEL_GAP);
+    *y -= r * (view_h + INFO_H);
+    return c < panel_cols() && *x < view_w && lane < lane_count ? lane : -1;
+}
+
+static void clamp_view(void) {
+    const MapDef *m = cur_map();
+    double max_x = m->cols - view_w / zoom, max_y = m->rows - view_h / zoom;
+    if (view_x > max_x) view_x = max_x;
+    if (view_y > max_y) view_y = max_y;
+    if (view_x < 0.0) view_x = 0.0;
+    if (view_y < 0.0) view_y = 0.0;
+}
+
+/* Zoom by `factor` keeping the cell under pixel (px, py) in place */
+static void zoom_at(double factor, int px, int py) {
+    double cx = view_x + px / zoom, cy = view_y + py / zoom;
+    zoom *= factor;
+    if (zoom < fit_zoom) zoom = fit_zoom;
+    if (zoom > MAX_ZOOM) zoom = MAX_ZOOM;
+    view_x = cx - px / zoom;
+    view_y = cy - py / zoom;
+    clamp_view();
+}
 
+static void pan_by(int dx, int dy) {
+    view_x -= dx / zoom;
+    view_y -= dy / zoom;
+    clamp_view();
+}
+
+/* Fit the map into MAX_WIN (RACE_WIN per panel in a race; at most
+ * MAX_CELL px per cell) and reset the view when the map changes */
 static void update_cell_size(void) {
-    const MapDef *m = all_maps[current_map];
-    int cw = MAX_WIN / m->cols;
-    int ch = MAX_WIN / m->rows;
-    cell_size = cw < ch ? cw : ch;
-    if (cell_size < MIN_CELL) cell_size = MIN_CELL;
-    if (cell_size > MAX_CELL) cell_size = MAX_CELL;
+    static const MapDef *fitted = NULL;
+    const MapDef *m = cur_map();
+    if (m == fitted) return;
+    fitted = m;
+    int fit = race ? RACE_WIN : MAX_WIN;
+    double zw = (double)fit / m->cols, zh = (double)fit / m->rows;
+    fit_zoom = zw < zh ? zw : zh;
+    if (fit_zoom >= 1.0) fit_zoom = (int)fit_zoom;   /* whole pixels per cell */
+    if (fit_zoom > MAX_CELL) fit_zoom = MAX_CELL;
+    view_w = (int)(m->cols * fit_zoom + 0.5);
+    view_h = (int)(m->rows * fit_zoom + 0.5);
+    zoom = fit_zoom;
+    view_x = view_y = 0.0;
 }
 
 /* ── Timing ──────────────────────────────────────────────────────── */
 
-static double step_us  = 0.0;
-static double total_us = 0.0;
-
-static void timed_step(void) {
+static void timed_step(Lane *l) {
+    heat_bind(&l->heat);
     Uint64 t0 = SDL_GetPerformanceCounter();
-    algorithms[current_alg]->step(vis);
+    algorithms[l->alg]->step(l->vis);
     Uint64 t1 = SDL_GetPerformanceCounter();
     double us = (double)(t1 - t0) * 1e6 / (double)SDL_GetPerformanceFrequency();
-    step_us = us;
-    total_us += us;
+    l->step_us = us;
+    l->total_us += us;
+    l->calls++;
 }
 
-static void init_algorithm(void) {
-    const MapDef *m = all_maps[current_map];
-    int total = m->rows * m->cols;
+/* ── Stepping ────────────────────────────────────────────────────── */
+
+/* At speed 0 auto-run steps for this long per frame instead of one step
+ * per tick; the worker publishes a snapshot after this long of stepping */
+#define FRAME_BUDGET_US 12000.0
+#define PUBLISH_US      4000.0
+#define FRAME_MS        16
+#define RACE_BATCH_MAX  (1 << 16)
+#define HEAT_MS         100
+
+/* Step until the search is done, max_steps steps ran or budget_us of step
+ * time has been spent */
+static void run_for(Lane *l, double budget_us, int max_steps) {
+    double spent = 0.0;
+    for (int n = 0; n < max_steps && !l->vis->done && spent < budget_us; n++) {
+        timed_step(l);
+        spent += l->step_us;
+    }
+}
 
-    /* Check if algorithm has a node cap and the map exceeds it */
-    if (algorithms[current_alg]->max_nodes > 0 &&
-        total > algorithms[current_alg]->max_nodes) {
-        /* Init with the map but mark as done immediately */
-        vis = algorithms[current_alg]->init(m);
-        vis->done = 1;
-        vis->found = 0;
+/* With --thread (always in a race), auto-run steps each lane on a worker
+ * thread */
+static int use_thread = 0;
+
+/* Copy the shown heat kind to heat_view, at most every HEAT_MS while the
+ * search runs. Called with the lane's lock held, if it has one. */
+static void publish_heat(Lane *l) {
+    if (heat_kind < 0 || !l->heat_view || l->heat_calls == l->calls) return;
+    Uint32 now = SDL_GetTicks();
+    if (l->heat_calls >= 0 && !l->vis->done && now - l->heat_copied < HEAT_MS)
+        return;
+    const uint32_t *count = l->heat.count[heat_kind];
+    memcpy(l->heat_view, count, (size_t)l->heat.cells * sizeof(uint32_t));
+    l->heat_max = l->heat.max[heat_kind];
+    l->heat_hot = -1;
+    l->heat_total = 0;
+    for (int i = 0; i < l->heat.cells; i++) {
+        l->heat_total += count[i];
+        if (count[i] == l->heat_max && l->heat_hot < 0 && l->heat_max > 0)
+            l->heat_hot = i;
+    }
+    l->heat_calls = l->calls;
+    l->heat_copied = now;
+    l->heat_fresh = 1;
+}
+
+/* Copy vis's changes and counters to what the UI reads. Called by the
+ * worker, or by the UI thread when no worker is running. */
+static void publish(Lane *l) {
+    AlgoVis *vis = l->vis, *snap = l->snap;
+    if (!use_thread) {
+        l->view = vis;
+        l->view_calls = l->calls;
+        l->view_step_us = l->step_us;
+        l->view_total_us = l->total_us;
+        publish_heat(l);
+        return;
+    }
+    SDL_LockMutex(l->lock);
+    publish_heat(l);
+    if (vis->dirty_all) {
+        memcpy(snap->cells, vis->cells, (size_t)vis->rows * vis->cols);
+        snap->dirty_count = 0;
+        snap->dirty_all = 1;
     } else {
-        vis = algorithms[current_alg]->init(m);
+        for (int k = 0; k < vis->dirty_count; k++)
+            vis_set_cell(snap, vis->dirty[k], vis->cells[vis->dirty[k]]);
+    }
+    snap->done = vis->done;
+    snap->found = vis->found;
+    snap->nodes_explored = vis->nodes_explored;
+    snap->steps = vis->steps;
+    snap->path_len = vis->path_len;
+    snap->path_cost = vis->path_cost;
+    snap->relaxations = vis->relaxations;
+    snap->rows = vis->rows;
+    snap->cols = vis->cols;
+    snap->start_node = vis->start_node;
+    snap->end_node = vis->end_node;
+    snap->phase = vis->phase;
+    memcpy(snap->phases, vis->phases, sizeof(snap->phases));
+    snap->phase_steps0 = vis->phase_steps0;
+    l->view_calls = l->calls;
+    l->view_step_us = l->step_us;
+    l->view_total_us = l->total_us;
+    l->view = snap;
+    SDL_UnlockMutex(l->lock);
+    vis_clear_dirty(vis);
+}
+
+static int worker_main(void *arg) {
+    Lane *l = arg;
+    while (!SDL_AtomicGet(&l->quit) && !l->vis->done) {
+        if (race && race_pace == PACE_STEP) {
+            /* Step up to the shared target, then wait for it to move */
+            int due = SDL_AtomicGet(&race_target) - l->calls;
+            if (due <= 0) {
+                SDL_Delay(1);
+                continue;
+            }
+            run_for(l, PUBLISH_US, due);
+            publish(l);
+            continue;
+        }
+        int ms = SDL_AtomicGet(&l->step_ms);
+        run_for(l, PUBLISH_US, ms > 0 ? 1 : INT_MAX);
+        publish(l);
+        if (ms > 0) SDL_Delay((Uint32)ms);
+    }
+    return 0;
+}
+
+static void worker_start(Lane *l) {
+    if (l->worker || l->vis->done) return;
+    SDL_AtomicSet(&l->quit, 0);
+    l->worker = SDL_CreateThread(worker_main, "search", l);
+    if (!l->worker)
+        fprintf(stderr, "SDL_CreateThread: %s\n", SDL_GetError());
+}
+
+/* Stop the lane's worker; its vis belongs to the UI thread again afterwards */
+static void worker_halt(Lane *l) {
+    if (!l->worker) return;
+    SDL_AtomicSet(&l->quit, 1);
+    SDL_WaitThread(l->worker, NULL);
+    l->worker = NULL;
+}
+
+static void halt_all(void) {
+    for (int i = 0; i < lane_count; i++)
+        worker_halt(&lanes[i]);
+}
+
+/* Step pacing: move the shared target on, by the ticks due at speeds
+ * above 0. At speed 0 it moves by a batch that doubles while every lane
+ * keeps up within a frame and halves while one lags behind. */
+static void race_advance(int step_ms, Uint32 *last_step) {
+    static int batch = 1;
+    int target = SDL_AtomicGet(&race_target);
+    int behind = 0;
+    for (int i = 0; i < lane_count; i++) {
+        lane_lock(&lanes[i]);
+        if (!lanes[i].view->done && lanes[i].view_calls < target) behind = 1;
+        lane_unlock(&lanes[i]);
+    }
+    if (step_ms > 0) {
+        Uint32 now = SDL_GetTicks();
+        if (now - *last_step >= (Uint32)step_ms) {
+            target += (int)((now - *last_step) / step_ms);
+            *last_step = now;
+        }
+    } else if (!behind) {
+        target += batch;
+        if (batch < RACE_BATCH_MAX) batch *= 2;
+    } else if (batch > 1) {
+        batch /= 2;
+    }
+    SDL_AtomicSet(&race_target, target);
+}
+
+/* Line the target up with the lane furthest ahead; lanes behind it catch
+ * up before any lane moves on */
+static void race_sync(void) {
+    int target = 0;
+    for (int i = 0; i < lane_count; i++) {
+        lane_lock(&lanes[i]);
+        if (lanes[i].view_calls > target) target = lanes[i].view_calls;
+        lane_unlock(&lanes[i]);
     }
+    SDL_AtomicSet(&race_target, target);
+}
+
+static void init_lane(Lane *l) {
+    const MapDef *m = cur_map();
+    if (HEAT_ENABLED && !replay) {
+        int cells = m->rows * m->cols;
+        if (l->heat.cells != cells) {
+            heat_free(&l->heat);
+            heat_alloc(&l->heat, cells);
+            free(l->heat_view);
+            l->heat_view = calloc((size_t)cells, sizeof(uint32_t));
+        } else {
+            heat_reset(&l->heat);
+        }
+        l->heat_calls = -1;
+        heat_bind(&l->heat);   /* init may already push the start */
+    }
+    l->vis = algorithms[l->alg]->init(m);
+    if (lane_skipped(l)) {
+        /* Init with the map but mark as done immediately */
+        l->vis->done = 1;
+        l->vis->found = 0;
+    }
+    l->calls = 0;
+    l->step_us = 0.0;
+    l->total_us = 0.0;
+    publish(l);
+}
+
+static void init_algorithm(void) {
+    if (!race) lanes[0].alg = current_alg;
+    for (int i = 0; i < lane_count; i++)
+        init_lane(&lanes[i]);
+    SDL_AtomicSet(&race_target, 0);
 
     update_cell_size();
     if (win)
         SDL_SetWindowSize(win, win_w(), win_h());
-
-    step_us = 0.0;
-    total_us = 0.0;
 }
 
 /* ── Rendering ───────────────────────────────────────────────────── */
@@ -175,37 +537,183 @@ static SDL_Color cell_color(int state) {
     }
 }
 
-static void render_grid(void) {
-    int rows = vis->rows, cols = vis->cols;
-    int gw = cols * cell_size, gh = rows * cell_size;
+/* Each lane's grid lives in a streaming texture with one ARGB pixel per
+ * cell, or per LOD block when zoomed out below a pixel per cell (lod.h),
+ * scaled on the blit (nearest-neighbour, SDL's default), so a frame costs
+ * one copy however big the map is. `seen` holds the cell states the
+ * texture shows and `px` its pixels; each frame applies the cells on the
+ * change list and uploads the bounding box of the blocks that changed.
+ * Set `stale` to force a full rebuild. */
+#define LOD_TEX_MAX 4096   /* texture side limit, in texels */
+
+static Uint32 cell_argb(int state) {
+    SDL_Color c = cell_color(state);
+    return 0xFF000000u | (Uint32)c.r << 16 | (Uint32)c.g << 8 | c.b;
+}
 
-    SDL_SetRenderDrawColor(ren, COL_BG.r, COL_BG.g, COL_BG.b, 255);
-    SDL_RenderClear(ren);
+/* Smallest power-of-two block with at least a pixel per block that keeps
+ * the texture within LOD_TEX_MAX */
+static int lod_block(int rows, int cols) {
+    int block = 1;
+    while (block < LOD_MAX_BLOCK &&
+           (zoom * block < 1.0 || (cols + block - 1) / block > LOD_TEX_MAX ||
+            (rows + block - 1) / block > LOD_TEX_MAX))
+        block *= 2;
+    return block;
+}
 
-    for (int r = 0; r < rows; r++) {
-        for (int c = 0; c < cols; c++) {
-            int idx = get_index(cols, r, c);
-            SDL_Color col = cell_color(vis->cells[idx]);
-            SDL_Rect rect = {
-                c * cell_size + GRID_PAD,
-                r * cell_size + GRID_PAD,
-                cell_size - 2 * GRID_PAD,
-                cell_size - 2 * GRID_PAD
-            };
-            SDL_SetRenderDrawColor(ren, col.r, col.g, col.b, 255);
-            SDL_RenderFillRect(ren, &rect);
+static void rebuild_grid(Lane *l, int rows, int cols, int block) {
+    if (l->lod.state) lod_free(&l->lod);
+    free(l->seen);
+    l->seen = malloc((size_t)rows * cols);
+    memcpy(l->seen, l->view->cells, (size_t)rows * cols);
+    lod_build(&l->lod, l->seen, rows, cols, block);
+
+    int n = l->lod.brows * l->lod.bcols;
+    free(l->px);
+    l->px = malloc((size_t)n * sizeof(Uint32));
+    for (int b = 0; b < n; b++)
+        l->px[b] = cell_argb(l->lod.state[b]);
+
+    if (l->tex) SDL_DestroyTexture(l->tex);
+    if (l->heat_tex) SDL_DestroyTexture(l->heat_tex);
+    l->heat_tex = NULL;
+    l->tex = SDL_CreateTexture(ren, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_STREAMING,
+                               l->lod.bcols, l->lod.brows);
+    SDL_UpdateTexture(l->tex, NULL, l->px, l->lod.bcols * (int)sizeof(Uint32));
+    l->stale = 0;
+}
+
+/* Heat ramp on a log scale, so the few very hot cells (a heap's
+ * favourite, a wall corner every line-of-sight check grazes) don't wash
+ * out the rest: dark purple -> red -> orange -> pale yellow */
+static Uint32 heat_argb(uint32_t v, uint32_t max) {
+    static const SDL_Color stops[] = {
+        {40, 10, 60, 255}, {200, 30, 40, 255}, {250, 140, 30, 255}, {255, 250, 190, 255},
+    };
+    double t = max > 0 ? log1p(v) / log1p(max) * 3.0 : 0.0;
+    int i = t >= 3.0 ? 2 : (int)t;
+    double f = t - i;
+    SDL_Color a = stops[i], b = stops[i + 1];
+    Uint32 r = (Uint32)(a.r + (b.r - a.r) * f);
+    Uint32 g = (Uint32)(a.g + (b.g - a.g) * f);
+    Uint32 bl = (Uint32)(a.b + (b.b - a.b) * f);
+    return 0xFF000000u | r << 16 | g << 8 | bl;
+}
+
+/* Rebuild the heat texture from heat_view, one texel per LOD block with
+ * the block's hottest cell. Blocks nothing touched keep their walls, and
+ * the path, start and end stay on top. */
+static void rebuild_heat(Lane *l) {
+    const Lod *d = &l->lod;
+    int n = d->brows * d->bcols;
+    if (!l->heat_tex) {
+        free(l->heat_px);
+        l->heat_px = malloc((size_t)n * sizeof(Uint32));
+        l->heat_tex = SDL_CreateTexture(ren, SDL_PIXELFORMAT_ARGB8888,
+                                        SDL_TEXTUREACCESS_STREAMING, d->bcols, d->brows);
+    }
+    for (int br = 0; br < d->brows; br++) {
+        for (int bc = 0; bc < d->bcols; bc++) {
+            uint32_t hot = 0;
+            int r1 = (br + 1) * d->block, c1 = (bc + 1) * d->block;
+            if (r1 > d->rows) r1 = d->rows;
+            if (c1 > d->cols) c1 = d->cols;
+            for (int r = br * d->block; r < r1; r++)
+                for (int c = bc * d->block; c < c1; c++)
+                    if (l->heat_view[r * d->cols + c] > hot)
+                        hot = l->heat_view[r * d->cols + c];
+            int b = br * d->bcols + bc, st = d->state[b];
+            if (st == VIS_PATH || st == VIS_START || st == VIS_END ||
+                (hot == 0 && st == VIS_WALL))
+                l->heat_px[b] = cell_argb(st);
+            else
+                l->heat_px[b] = hot ? heat_argb(hot, l->heat_max) : 0xFF141020u;
         }
     }
+    SDL_UpdateTexture(l->heat_tex, NULL, l->heat_px, d->bcols * (int)sizeof(Uint32));
+    l->heat_fresh = 0;
+}
+
+/* Draw the lane's grid at the origin of the current render viewport */
+static void render_grid(Lane *l) {
+    AlgoVis *view = l->view;
+    int rows = view->rows, cols = view->cols;
+    int block = lod_block(rows, cols);
+
+    if (l->stale || view->dirty_all || !l->tex || l->lod.rows != rows ||
+        l->lod.cols != cols || l->lod.block != block) {
+        rebuild_grid(l, rows, cols, block);
+    } else if (view->dirty_count > 0) {
+        int bcols = l->lod.bcols;
+        int r0 = l->lod.brows, c0 = bcols, r1 = -1, c1 = -1;
+        for (int k = 0; k < view->dirty_count; k++) {
+            int idx = view->dirty[k];
+            if (l->seen[idx] == view->cells[idx]) continue;
+            int b = lod_update(&l->lod, idx, l->seen[idx], view->cells[idx]);
+            l->seen[idx] = view->cells[idx];
+            if (b < 0) continue;
+            l->px[b] = cell_argb(l->lod.state[b]);
+            int r = b / bcols, c = b % bcols;
+            if (r < r0) r0 = r;
+            if (r > r1) r1 = r;
+            if (c < c0) c0 = c;
+            if (c > c1) c1 = c;
+        }
+        if (r1 >= 0) {
+            SDL_Rect box = {c0, r0, c1 - c0 + 1, r1 - r0 + 1};
+            SDL_UpdateTexture(l->tex, &box, l->px + r0 * bcols + c0,
+                              bcols * (int)sizeof(Uint32));
+        }
+    }
+    vis_clear_dirty(view);
+
+    /* The heat texture follows the grid's LOD layout; rebuilding the grid
+     * drops it, new counts refresh it */
+    SDL_Texture *shown = l->tex;
+    if (heat_kind >= 0 && l->heat_view) {
+        if (!l->heat_tex || l->heat_fresh) rebuild_heat(l);
+        shown = l->heat_tex;
+    }
+
+    /* Copy the visible texels; clip to the grid area and the map's edge,
+     * which a partial last block would otherwise overhang */
+    double x1 = view_x + view_w / zoom, y1 = view_y + view_h / zoom;
+    SDL_Rect src;
+    src.x = (int)(view_x / block);
+    src.y = (int)(view_y / block);
+    src.w = (int)ceil(x1 / block) - src.x;
+    src.h = (int)ceil(y1 / block) - src.y;
+    if (src.x + src.w > l->lod.bcols) src.w = l->lod.bcols - src.x;
+    if (src.y + src.h > l->lod.brows) src.h = l->lod.brows - src.y;
+    int dx0 = (int)floor((src.x * block - view_x) * zoom);
+    int dy0 = (int)floor((src.y * block - view_y) * zoom);
+    SDL_Rect dst = {
+        dx0, dy0,
+        (int)ceil(((src.x + src.w) * block - view_x) * zoom) - dx0,
+        (int)ceil(((src.y + src.h) * block - view_y) * zoom) - dy0
+    };
+    SDL_Rect clip = {0, 0, view_w, view_h};
+    int map_w = (int)ceil((cols - view_x) * zoom), map_h = (int)ceil((rows - view_y) * zoom);
+    if (clip.w > map_w) clip.w = map_w;
+    if (clip.h > map_h) clip.h = map_h;
+    SDL_RenderSetClipRect(ren, &clip);
+    SDL_RenderCopy(ren, shown, &src, &dst);
 
     /* Grid lines (skip if cells are very small) */
-    if (cell_size >= 6) {
+    if (zoom >= 6.0) {
         SDL_SetRenderDrawColor(ren, COL_GRID_LINE.r, COL_GRID_LINE.g,
                                COL_GRID_LINE.b, 255);
-        for (int r = 0; r <= rows; r++)
-            SDL_RenderDrawLine(ren, 0, r * cell_size, gw, r * cell_size);
-        for (int c = 0; c <= cols; c++)
-            SDL_RenderDrawLine(ren, c * cell_size, 0, c * cell_size, gh);
+        for (int r = (int)ceil(view_y); r <= rows && r <= y1; r++) {
+            int y = (int)((r - view_y) * zoom);
+            SDL_RenderDrawLine(ren, 0, y, clip.w, y);
+        }
+        for (int c = (int)ceil(view_x); c <= cols && c <= x1; c++) {
+            int x = (int)((c - view_x) * zoom);
+            SDL_RenderDrawLine(ren, x, 0, x, clip.h);
+        }
     }
+    SDL_RenderSetClipRect(ren, NULL);
 }
 
 static void draw_char_block(int x, int y, int w, int h) {
@@ -213,24 +721,25 @@ static void draw_char_block(int x, int y, int w, int h) {
     SDL_RenderFillRect(ren, &r);
 }
 
-static void render_info(int step_ms) {
+/* Info bar under the lane's grid, in the current render viewport */
+static void render_info(Lane *l, int step_ms) {
     (void)step_ms;
-    int rows = vis->rows;
-    int w = win_w();
-    int y0 = rows * cell_size + 4;
+    AlgoVis *view = l->view;
+    int w = view_w;
+    int y0 = view_h + 4;
 
-    SDL_Rect bar = {0, rows * cell_size, w, INFO_H};
+    SDL_Rect bar = {0, view_h, w, INFO_H};
     SDL_SetRenderDrawColor(ren, 20, 20, 25, 255);
     SDL_RenderFillRect(ren, &bar);
 
     /* Algorithm indicator — colored block */
-    SDL_Color ac = alg_colors[current_alg];
+    SDL_Color ac = alg_colors[l->alg];
     SDL_SetRenderDrawColor(ren, ac.r, ac.g, ac.b, 255);
     draw_char_block(8, y0 + 4, 12, 12);
 
     /* Status indicator */
-    if (vis->done) {
-        SDL_Color sc = vis->found ? COL_PATH : COL_END;
+    if (view->done) {
+        SDL_Color sc = view->found ? COL_PATH : COL_END;
         SDL_SetRenderDrawColor(ren, sc.r, sc.g, sc.b, 255);
         draw_char_block(w - 20, y0 + 4, 12, 12);
     }
@@ -249,12 +758,8 @@ static void render_info(int step_ms) {
     }
 
     /* Progress bar */
-    const MapDef *m = all_maps[current_map];
-    int total = m->rows * m->cols;
-    int total_open = 0;
-    for (int i = 0; i < total; i++)
-        if (m->data[i] == 0) total_open++;
-    int bar_w = (vis->nodes_explored * (w - 16)) / (total_open > 0 ? total_open : 1);
+    int total_open = cur_info()->open;
+    int bar_w = (view->nodes_explored * (w - 16)) / (total_open > 0 ? total_open : 1);
     if (bar_w > w - 16) bar_w = w - 16;
     SDL_SetRenderDrawColor(ren, 80, 80, 100, 255);
     SDL_Rect prog = {8, y0 + 48, bar_w, 6};
@@ -263,46 +768,148 @@ static void render_info(int step_ms) {
 
 /* ── Terminal stats ──────────────────────────────────────────────── */
 
-#define STATS_LINES 5
+/* The block is built in stats_buf and only written when it differs from
+ * what is on screen, so an idle visualizer leaves the terminal alone */
+static char stats_buf[1024], stats_shown[1024];
+static size_t stats_len = 0;
+
+static void stats_printf(const char *fmt, ...) {
+    size_t room = sizeof(stats_buf) - stats_len;
+    va_list ap;
+    va_start(ap, fmt);
+    int n = vsnprintf(stats_buf + stats_len, room, fmt, ap);
+    va_end(ap);
+    if (n > 0) stats_len += (size_t)n < room ? (size_t)n : room - 1;
+}
 
-static void print_stats(int step_ms, int first) {
-    if (!first)
-        printf("\033[%dA", STATS_LINES);
+static void speed_str(char *buf, size_t n, int step_ms) {
+    if (step_ms > 0)
+        snprintf(buf, n, "%dms", step_ms);
+    else
+        snprintf(buf, n, "max");
+}
 
-    const MapDef *m = all_maps[current_map];
+static void lane_stats(Lane *l, int step_ms) {
+    const MapDef *m = cur_map();
+    const MapInfo *info = cur_info();
+    AlgoVis *view = l->view;
     const char *status;
-    if (algorithms[current_alg]->max_nodes > 0 &&
-        m->rows * m->cols > algorithms[current_alg]->max_nodes)
+    if (lane_skipped(l))
         status = "SKIPPED (too large)";
     else
-        status = vis->done ? (vis->found ? "FOUND" : "NO PATH") : "searching";
-    int path_cost = vis->found ? vis->path_cost : -1;
-
-    printf("\033[K  %-16s %-14s %s [%dx%d]\n",
-           m->name, algorithms[current_alg]->name, status, m->cols, m->rows);
+        status = view->done ? (view->found ? "FOUND" : "NO PATH") : "searching";
+    int path_cost = view->found ? view->path_cost : -1;
+
+    if (replay)
+        stats_printf("\033[K  %-16s %-14s %s [%dx%d, %d open, %d comp]  replay %d/%d x%d\n",
+                     m->name, algorithms[l->alg]->name, status, m->cols, m->rows,
+                     info->open, info->components,
+                     replay_pos, replay_steps(replay), replay_stride);
+    else
+        stats_printf("\033[K  %-16s %-14s %s [%dx%d, %d open, %d comp]\n",
+                     m->name, algorithms[l->alg]->name, status, m->cols, m->rows,
+                     info->open, info->components);
 
     char step_buf[32], total_buf[32];
-    snprintf(step_buf, sizeof(step_buf), "%.1fus", step_us);
-    snprintf(total_buf, sizeof(total_buf), "%.1fus", total_us);
+    snprintf(step_buf, sizeof(step_buf), "%.1fus", l->view_step_us);
+    snprintf(total_buf, sizeof(total_buf), "%.1fus", l->view_total_us);
 
-    if (vis->found)
-        printf("\033[K  explored: %-8d steps: %-8d  path: %d (%d nodes)\n",
-               vis->nodes_explored, vis->steps, path_cost, vis->path_len);
+    if (view->found)
+        stats_printf("\033[K  explored: %-8d steps: %-8d  path: %d (%d nodes)\n",
+                     view->nodes_explored, view->steps, path_cost, view->path_len);
     else
-        printf("\033[K  explored: %-8d steps: %-8d  path: --\n",
-               vis->nodes_explored, vis->steps);
+        stats_printf("\033[K  explored: %-8d steps: %-8d  path: --\n",
+                     view->nodes_explored, view->steps);
 
-    printf("\033[K  relax:    %-8d\n", vis->relaxations);
+    stats_printf("\033[K  relax:    %-8d\n", view->relaxations);
 
-    printf("\033[K  step:     %-8s total: %-8s speed: %dms\n",
-           step_buf, total_buf, step_ms);
+    char speed_buf[16];
+    speed_str(speed_buf, sizeof(speed_buf), step_ms);
+    stats_printf("\033[K  step:     %-8s total: %-8s speed: %s%s\n",
+                     step_buf, total_buf, speed_buf, use_thread ? " (thread)" : "");
 
-    double nps = (total_us > 0.0) ? (vis->nodes_explored * 1e6 / total_us) : 0.0;
+    double nps = (l->view_total_us > 0.0) ? (view->nodes_explored * 1e6 / l->view_total_us) : 0.0;
     char nps_buf[32];
     snprintf(nps_buf, sizeof(nps_buf), "%.0f", nps);
-    printf("\033[K  nodes/s:  %s\n", nps_buf);
+    stats_printf("\033[K  nodes/s:  %s\n", nps_buf);
+
+    /* Steps per phase; the open phase is still accumulating */
+    stats_printf("\033[K  phase:    %-10s", view->phase < PHASE_COUNT ? phase_names[view->phase] : "done");
+    for (int p = 0; p < PHASE_COUNT; p++) {
+        int steps = view->phases[p].steps;
+        if (p == view->phase) steps += view->steps - view->phase_steps0;
+        if (steps > 0) stats_printf(" %s %d", phase_names[p], steps);
+    }
+    stats_printf("\n");
+
+    if (heat_kind >= 0 && l->heat_view) {
+        if (l->heat_hot >= 0)
+            stats_printf("\033[K  heat:     %-8s max %u at (%d,%d)  total %lld\n",
+                         heat_names[heat_kind], l->heat_max, l->heat_hot / m->cols,
+                         l->heat_hot % m->cols, l->heat_total);
+        else
+            stats_printf("\033[K  heat:     %-8s --\n", heat_names[heat_kind]);
+    }
+}
 
+/* One line per lane: step() calls, counters and step time so far */
+static void race_stats(int step_ms) {
+    const MapDef *m = cur_map();
+    const MapInfo *info = cur_info();
+    char speed_buf[16];
+    speed_str(speed_buf, sizeof(speed_buf), step_ms);
+    stats_printf("\033[K  %-16s race, %s pacing [%dx%d, %d open, %d comp]  speed: %s%s%s\n",
+                 m->name, race_pace == PACE_STEP ? "step" : "time", m->cols, m->rows,
+                 info->open, info->components, speed_buf,
+                 heat_kind >= 0 ? "  heat: " : "", heat_kind >= 0 ? heat_names[heat_kind] : "");
+
+    for (int i = 0; i < lane_count; i++) {
+        Lane *l = &lanes[i];
+        lane_lock(l);
+        AlgoVis *view = l->view;
+        const char *status;
+        if (lane_skipped(l))
+            status = "SKIPPED";
+        else
+            status = view->done ? (view->found ? "FOUND" : "NO PATH") : "searching";
+        char cost_buf[16];
+        if (view->found)
+            snprintf(cost_buf, sizeof(cost_buf), "%d", view->path_cost);
+        else
+            snprintf(cost_buf, sizeof(cost_buf), "--");
+        stats_printf("\033[K  %-14s %-9s calls: %-8d explored: %-8d relax: %-9d path: %-6s %.1fus\n",
+                     algorithms[l->alg]->name, status, l->view_calls, view->nodes_explored,
+                     view->relaxations, cost_buf, l->view_total_us);
+        lane_unlock(l);
+    }
+}
+
+static int count_lines(const char *s) {
+    int n = 0;
+    for (; *s; s++)
+        if (*s == '\n') n++;
+    return n;
+}
+
+static void print_stats(int step_ms, int first) {
+    stats_len = 0;
+    stats_buf[0] = '\0';
+
+    if (race) {
+        race_stats(step_ms);
+    } else {
+        lane_lock(&lanes[0]);
+        lane_stats(&lanes[0], step_ms);
+        lane_unlock(&lanes[0]);
+    }
+
+    if (!first && strcmp(stats_buf, stats_shown) == 0)
+        return;
+    if (!first)
+        printf("\033[%dA", count_lines(stats_shown));
+    fputs(stats_buf, stdout);
     fflush(stdout);
+    memcpy(stats_shown, stats_buf, stats_len + 1);
 }
 
 /* ── Benchmark mode ──────────────────────────────────────────────── */
@@ -325,32 +932,35 @@ static void run_benchmark(void) {
     /* Re-init and run to completion without rendering */
     init_algorithm();
 
-    const MapDef *m = all_maps[current_map];
+    Lane *l = &lanes[0];
+    AlgoVis *vis = l->vis;
+    const MapDef *m = cur_map();
 
     /* Skip if algorithm can't handle this map size */
-    if (algorithms[current_alg]->max_nodes > 0 &&
-        m->rows * m->cols > algorithms[current_alg]->max_nodes) {
+    if (lane_skipped(l)) {
         print_stats(0, 1);
         return;
     }
 
+    heat_bind(&l->heat);
     Uint64 t0 = SDL_GetPerformanceCounter();
-    while (algorithms[current_alg]->step(vis)) {}
+    while (algorithms[l->alg]->step(vis)) {}
     Uint64 t1 = SDL_GetPerformanceCounter();
 
-    total_us = (double)(t1 - t0) * 1e6 / (double)SDL_GetPerformanceFrequency();
-    step_us = 0.0;
+    l->total_us = (double)(t1 - t0) * 1e6 / (double)SDL_GetPerformanceFrequency();
+    l->step_us = 0.0;
+    publish(l);
 
     /* Record result */
     if (bench_count < BENCH_MAX) {
-        bench_log[bench_count].alg_name = algorithms[current_alg]->name;
+        bench_log[bench_count].alg_name = algorithms[l->alg]->name;
         bench_log[bench_count].map_name = m->name;
         bench_log[bench_count].map_rows = m->rows;
         bench_log[bench_count].map_cols = m->cols;
         bench_log[bench_count].path_cost = vis->found ? vis->path_cost : -1;
         bench_log[bench_count].nodes_explored = vis->nodes_explored;
         bench_log[bench_count].relaxations = vis->relaxations;
-        bench_log[bench_count].total_us = total_us;
+        bench_log[bench_count].total_us = l->total_us;
         bench_count++;
     }
 
@@ -370,6 +980,64 @@ static void run_benchmark(void) {
 
 /* ── Main ────────────────────────────────────────────────────────── */
 
+/* Replay-mode keys; returns 1 if the key was consumed. Keys that switch
+ * algorithms, maps or benchmark do nothing during playback. */
+static int replay_key(SDL_Keycode key, int *auto_run) {
+    int n = replay_steps(replay);
+    switch (key) {
+    case SDLK_SPACE: case SDLK_RIGHT:
+        replay_goto(replay_pos + 1);
+        break;
+    case SDLK_LEFT: case SDLK_BACKSPACE:
+        replay_goto(replay_pos - 1);
+        break;
+    case SDLK_HOME:     replay_goto(0); break;
+    case SDLK_END:      replay_goto(n); break;
+    case SDLK_PAGEUP:   replay_goto(replay_pos - (n + 9) / 10); break;
+    case SDLK_PAGEDOWN: replay_goto(replay_pos + (n + 9) / 10); break;
+    case SDLK_LEFTBRACKET:
+        if (replay_stride > 1) replay_stride /= 2;
+        return 1;
+    case SDLK_RIGHTBRACKET:
+        if (replay_stride < (1 << 20)) replay_stride *= 2;
+        return 1;
+    case SDLK_0: case SDLK_1: case SDLK_2: case SDLK_3: case SDLK_4:
+    case SDLK_5: case SDLK_6: case SDLK_7: case SDLK_8: case SDLK_9:
+        replay_goto((int)((long long)n * (key - SDLK_0) / 10));
+        break;
+    case SDLK_TAB: case SDLK_b:
+    case SDLK_F1: case SDLK_F2: case SDLK_F3: case SDLK_F4:
+        return 1;
+    default:
+        return 0;
+    }
+    *auto_run = 0;
+    return 1;
+}
+
+/* Race-mode keys; returns 1 if the key was consumed. Keys that switch
+ * algorithms or benchmark do nothing in a race. */
+static int race_key(SDL_Keycode key, int *auto_run) {
+    switch (key) {
+    case SDLK_SPACE:
+        for (int i = 0; i < lane_count; i++)
+            if (!lanes[i].vis->done) timed_step(&lanes[i]);
+        break;
+    case SDLK_p:
+        race_pace = race_pace == PACE_STEP ? PACE_TIME : PACE_STEP;
+        if (race_pace == PACE_STEP) race_sync();
+        return 1;
+    case SDLK_0: case SDLK_1: case SDLK_2: case SDLK_3: case SDLK_4:
+    case SDLK_5: case SDLK_6: case SDLK_7: case SDLK_8: case SDLK_9:
+    case SDLK_F1: case SDLK_F2: case SDLK_F3: case SDLK_F4: case SDLK_b:
+        return 1;
+    default:
+        return 0;
+    }
+    *auto_run = 0;
+    return 1;
+}
+
 static int use_cpu = 0;
 
 static void select_algorithms(int argc, char *argv[]) {
@@ -380,27 +1048,42 @@ static void select_algorithms(int argc, char *argv[]) {
 
         /* Flags */
         if (strcmp(arg, "--cpu") == 0) { use_cpu = 1; continue; }
+        if (strcmp(arg, "--thread") == 0) { use_thread = 1; continue; }
+        if (strcmp(arg, "--race") == 0) { race = 1; continue; }
+        if (strcmp(arg, "--pace") == 0 && a + 1 < argc) {
+            const char *pace = argv[++a];
+            if (strcmp(pace, "step") == 0) {
+                race_pace = PACE_STEP;
+            } else if (strcmp(pace, "time") == 0) {
+                race_pace = PACE_TIME;
+            } else {
+                fprintf(stderr, "--pace: expected step or time, got '%s'\n", pace);
+                exit(1);
+            }
+            continue;
+        }
+        if (strcmp(arg, "--replay") == 0 && a + 1 < argc) {
+            replay = replay_open(argv[++a]);
+            if (!replay) exit(1);
+            continue;
+        }
         if (strcmp(arg, "--help") == 0 || strcmp(arg, "-h") == 0) {
-            printf("Usage: visualizer [--cpu] [algo ...]\n");
+            printf("Usage: visualizer [--cpu] [--thread] [--race [--pace step|time]] [--replay FILE] [algo ...]\n");
             printf("  --cpu     Use software renderer (default: GPU)\n");
+            printf("  --thread  Auto-run the search on a worker thread\n");
+            printf("  --race    Run 2-%d algorithms side by side, each on its own thread\n", LANE_MAX);
+            printf("  --pace    Race pacing: equal step() calls (step, default) or equal time\n");
+            printf("  --replay  Play back a recording from rrrlz-bench --record\n");
             printf("  algo      Algorithm name prefix (case-insensitive). Available:\n           ");
             for (int i = 0; i < ALG_MAX; i++)
                 printf(" %s", all_algorithms[i]->name);
-            printf("\n  No algo args = load all\n");
+            printf("\n  No algo args = load all (race: the first %d)\n", LANE_MAX);
             exit(0);
         }
 
         /* Match arg against algorithm names (case-insensitive prefix) */
         for (int i = 0; i < ALG_MAX; i++) {
-            const char *name = all_algorithms[i]->name;
-            int match = 1;
-            for (int k = 0; arg[k]; k++) {
-                char ac = arg[k], nc = name[k];
-                if (!nc) { match = 0; break; }
-                if (ac >= 'A' && ac <= 'Z') ac += 32;
-                if (nc >= 'A' && nc <= 'Z') nc += 32;
-                if (ac != nc) { match = 0; break; }
-            }
+            int match = name_prefix_match(arg, all_algorithms[i]->name);
             if (match && alg_count < ALG_MAX) {
                 int dup = 0;
                 for (int j = 0; j < alg_count; j++)
@@ -414,6 +1097,22 @@ static void select_algorithms(int argc, char *argv[]) {
         }
     }
 
+    if (replay) {
+        if (race) {
+            fprintf(stderr, "--race and --replay cannot be combined\n");
+            exit(1);
+        }
+        use_thread = 0;   /* seeking is cheap; playback stays on the UI thread */
+        replay_plugin.name = replay_alg(replay);
+        algorithms[0] = &replay_plugin;
+        alg_colors[0] = all_alg_colors[0];
+        for (int i = 0; i < ALG_MAX; i++)
+            if (strcmp(all_algorithms[i]->name, replay_plugin.name) == 0)
+                alg_colors[0] = all_alg_colors[i];
+        alg_count = 1;
+        return;
+    }
+
     /* No algo args = load all */
     if (alg_count == 0) {
         for (int i = 0; i < ALG_MAX; i++) {
@@ -422,6 +1121,22 @@ static void select_algorithms(int argc, char *argv[]) {
         }
         alg_count = ALG_MAX;
     }
+
+    /* Race: one lane per algorithm, each on its own worker */
+    if (race) {
+        if (alg_count < 2) {
+            fprintf(stderr, "--race needs 2-%d different algorithms\n", LANE_MAX);
+            exit(1);
+        }
+        if (alg_count > LANE_MAX) {
+            fprintf(stderr, "--race: using the first %d algorithms\n", LANE_MAX);
+            alg_count = LANE_MAX;
+        }
+        lane_count = alg_count;
+        for (int i = 0; i < lane_count; i++)
+            lanes[i].alg = i;
+        use_thread = 1;
+    }
 }
 
 int main(int argc, char *argv[]) {
@@ -460,6 +1175,23 @@ int main(int argc, char *argv[]) {
         return 1;
     }
 
+    /* Worker lanes publish into a snapshot under their own lock */
+    for (int i = 0; use_thread && i < lane_count; i++) {
+        lanes[i].lock = SDL_CreateMutex();
+        lanes[i].snap = calloc(1, sizeof(AlgoVis));
+        if (!lanes[i].lock || !lanes[i].snap) {
+            fprintf(stderr, "SDL_CreateMutex: %s\n", SDL_GetError());
+            if (race) {
+                SDL_DestroyRenderer(ren);
+                SDL_DestroyWindow(win);
+                SDL_Quit();
+                return 1;
+            }
+            use_thread = 0;
+        }
+    }
+    for (int i = 0; i < lane_count; i++)
+        lanes[i].stale = 1;
     init_algorithm();
 
     int running = 1;
@@ -467,33 +1199,77 @@ int main(int argc, char *argv[]) {
     int step_ms = 40;
     Uint32 last_step = 0;
 
-    printf("Pathfinding Visualizer (%d algorithms loaded)\n", alg_count);
-    printf("  Space = step       Enter = auto-run   R   = reset    B = benchmark\n");
-    printf("  Algorithms: ");
-    for (int i = 0; i < alg_count; i++)
-        printf("%d=%s ", i + 1, algorithms[i]->name);
-    printf("\n");
-    printf("  Tab = next map     +/- = speed        Q/Esc = quit\n");
+    if (replay) {
+        printf("Pathfinding Visualizer (replay: %s on %s, %d steps)\n",
+               replay_alg(replay), cur_map()->name, replay_steps(replay));
+        printf("  Space/Right = step  Left = back  Enter = play  [/] = steps per tick\n");
+        printf("  Home/End = ends     PgUp/PgDn = 10%%  0-9 = seek  +/- = speed  Q/Esc = quit\n");
+        printf("  Wheel = zoom        Drag = pan        Z = fit map\n");
+    } else if (race) {
+        printf("Pathfinding Visualizer (race:");
+        for (int i = 0; i < lane_count; i++)
+            printf(" %s", algorithms[i]->name);
+        printf(")\n");
+        printf("  Space = step all   Enter = auto-run   R   = reset    P = step/time pacing\n");
+        printf("  Tab = next map     +/- = speed        Q/Esc = quit\n");
+        printf("  Wheel = zoom       Drag = pan         Z   = fit map%s\n",
+               HEAT_ENABLED ? "  H = heat" : "");
+    } else {
+        printf("Pathfinding Visualizer (%d algorithms loaded)\n", alg_count);
+        printf("  Space = step       Enter = auto-run   R   = reset    B = benchmark\n");
+        printf("  Algorithms: ");
+        for (int i = 0; i < alg_count; i++)
+            printf("%d=%s ", i + 1, algorithms[i]->name);
+        printf("\n");
+        printf("  Tab = next map     +/- = speed        Q/Esc = quit\n");
+        printf("  Wheel = zoom       Drag = pan         Z   = fit map%s\n",
+               HEAT_ENABLED ? "  H = heat" : "");
+    }
     printf("\n");
     print_stats(step_ms, 1);
 
     while (running) {
+        Uint32 frame_start = SDL_GetTicks();
         SDL_Event ev;
         while (SDL_PollEvent(&ev)) {
             if (ev.type == SDL_QUIT) {
                 running = 0;
+            } else if (ev.type == SDL_RENDER_TARGETS_RESET ||
+                       ev.type == SDL_RENDER_DEVICE_RESET) {
+                for (int i = 0; i < lane_count; i++)
+                    lanes[i].stale = 1;
+            } else if (ev.type == SDL_MOUSEWHEEL) {
+                int mx, my;
+                SDL_GetMouseState(&mx, &my);
+                if (panel_at(&mx, &my) >= 0 && my < view_h && ev.wheel.y != 0)
+                    zoom_at(ev.wheel.y > 0 ? 1.25 : 0.8, mx, my);
+            } else if (ev.type == SDL_MOUSEMOTION &&
+                       (ev.motion.state & SDL_BUTTON_LMASK)) {
+                pan_by(ev.motion.xrel, ev.motion.yrel);
             } else if (ev.type == SDL_KEYDOWN) {
-                switch (ev.key.keysym.sym) {
+                SDL_Keycode key = ev.key.keysym.sym;
+                /* Every key but play/pause, speed and view touches vis */
+                if (key != SDLK_RETURN && key != SDLK_EQUALS &&
+                    key != SDLK_PLUS && key != SDLK_MINUS && key != SDLK_z)
+                    halt_all();
+                if (replay && replay_key(key, &auto_run))
+                    continue;
+                if (race && race_key(key, &auto_run))
+                    continue;
+                switch (key) {
                 case SDLK_q:
                 case SDLK_ESCAPE:
                     running = 0;
                     break;
                 case SDLK_SPACE:
                     auto_run = 0;
-                    timed_step();
+                    timed_step(&lanes[0]);
                     break;
                 case SDLK_RETURN:
                     auto_run = !auto_run;
+                    last_step = SDL_GetTicks();
+                    if (race && auto_run && race_pace == PACE_STEP)
+                        race_sync();
                     break;
                 case SDLK_r:
                     init_algorithm();
@@ -502,7 +1278,7 @@ int main(int argc, char *argv[]) {
                 case SDLK_1: case SDLK_2: case SDLK_3: case SDLK_4:
                 case SDLK_5: case SDLK_6: case SDLK_7: case SDLK_8:
                 case SDLK_9: {
-                    int idx = ev.key.keysym.sym - SDLK_1;
+                    int idx = key - SDLK_1;
                     if (idx < alg_count) {
                         current_alg = idx;
                         init_algorithm();
@@ -518,7 +1294,7 @@ int main(int argc, char *argv[]) {
                     }
                     break;
                 case SDLK_F1: case SDLK_F2: case SDLK_F3: case SDLK_F4: {
-                    int idx = 10 + (ev.key.keysym.sym - SDLK_F1);
+                    int idx = 10 + (key - SDLK_F1);
                     if (idx < alg_count) {
                         current_alg = idx;
                         init_algorithm();
@@ -537,36 +1313,98 @@ int main(int argc, char *argv[]) {
                     break;
                 case SDLK_EQUALS:
                 case SDLK_PLUS:
-                    if (step_ms > 5) step_ms -= 5;
+                    if (step_ms > 0) step_ms -= 5;
                     break;
                 case SDLK_MINUS:
                     if (step_ms < 500) step_ms += 5;
                     break;
+                case SDLK_z:
+                    zoom = fit_zoom;
+                    view_x = view_y = 0.0;
+                    break;
+                case SDLK_h:
+                    /* Off -> each kind -> off; the workers are halted, so
+                     * the views can be refreshed from here */
+                    if (!HEAT_ENABLED || replay) break;
+                    heat_kind = heat_kind + 1 < HEAT_KINDS ? heat_kind + 1 : -1;
+                    for (int i = 0; i < lane_count; i++) {
+                        lanes[i].heat_calls = -1;
+                        publish(&lanes[i]);
+                    }
+                    break;
                 default:
                     break;
                 }
             }
         }
 
-        if (auto_run && !vis->done) {
-            Uint32 now = SDL_GetTicks();
-            if (now - last_step >= (Uint32)step_ms) {
-                timed_step();
-                last_step = now;
+        /* Auto-run: the workers step in the background (a step-paced race
+         * up to the shared target); otherwise run the steps due since the
+         * last frame (at speed 0, as many as fit in the frame budget) */
+        for (int i = 0; i < lane_count; i++)
+            SDL_AtomicSet(&lanes[i].step_ms, step_ms);
+        if (use_thread && auto_run) {
+            if (race && race_pace == PACE_STEP)
+                race_advance(step_ms, &last_step);
+            for (int i = 0; i < lane_count; i++)
+                worker_start(&lanes[i]);
+        } else {
+            halt_all();
+            int due = 0;
+            if (auto_run) {
+                Uint32 now = SDL_GetTicks();
+                if (step_ms == 0) {
+                    due = INT_MAX;
+                } else if (now - last_step >= (Uint32)step_ms) {
+                    due = (int)((now - last_step) / step_ms);
+                    last_step = now;
+                }
+            }
+            for (int i = 0; i < lane_count; i++) {
+                if (due > 0) run_for(&lanes[i], FRAME_BUDGET_US, due);
+                publish(&lanes[i]);
             }
         }
 
-        render_grid();
-        render_info(step_ms);
-        SDL_RenderPresent(ren);
-
+        SDL_SetRenderDrawColor(ren, COL_BG.r, COL_BG.g, COL_BG.b, 255);
+        SDL_RenderClear(ren);
+        for (int i = 0; i < lane_count; i++) {
+            SDL_Rect panel = panel_rect(i);
+            SDL_RenderSetViewport(ren, &panel);
+            lane_lock(&lanes[i]);
+            render_grid(&lanes[i]);
+            render_info(&lanes[i], step_ms);
+            lane_unlock(&lanes[i]);
+        }
+        SDL_RenderSetViewport(ren, NULL);
         print_stats(step_ms, 0);
+        SDL_RenderPresent(ren);
 
-        SDL_Delay(8);
+        Uint32 frame_ms = SDL_GetTicks() - frame_start;
+        if (frame_ms < FRAME_MS)
+            SDL_Delay(FRAME_MS - frame_ms);
     }
 
     printf("\n");
 
+    halt_all();
+    for (int k = 0; k <= MAP_COUNT; k++)
+        if (map_info_ready[k]) map_info_free(&map_infos[k]);
+
+    replay_close(replay);
+    for (int i = 0; i < lane_count; i++) {
+        Lane *l = &lanes[i];
+        if (l->lock) SDL_DestroyMutex(l->lock);
+        free(l->snap);
+        if (l->tex) SDL_DestroyTexture(l->tex);
+        free(l->px);
+        free(l->seen);
+        if (l->lod.state) lod_free(&l->lod);
+        if (l->heat_tex) SDL_DestroyTexture(l->heat_tex);
+        free(l->heat_px);
+        free(l->heat_view);
+        heat_free(&l->heat);
+    }
     SDL_DestroyRenderer(ren);
     SDL_DestroyWindow(win);
     SDL_Quit();
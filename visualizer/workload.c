@@ -0,0 +1,90 @@
+/*
+ * workload.c — Random start/goal query workloads
+ */
+
+#include "workload.h"
+
+void bfs_distances(const MapDef *map, int src, int *dist) {
+    int total = map->rows * map->cols;
+    int cols = map->cols;
+    int *queue = malloc(total * sizeof(int));
+
+    for (int i = 0; i < total; i++)
+        dist[i] = -1;
+
+    int head = 0, tail = 0;
+    dist[src] = 0;
+    queue[tail++] = src;
+    while (head < tail) {
+        int node = queue[head++];
+        int r = node / cols, c = node % cols;
+        for (int d = 0; d < 4; d++) {
+            int nr = r + DR[d], nc = c + DC[d];
+            if (!is_valid(map, nr, nc)) continue;
+            int ni = get_index(cols, nr, nc);
+            if (dist[ni] >= 0) continue;
+            dist[ni] = dist[node] + 1;
+            queue[tail++] = ni;
+        }
+    }
+
+    free(queue);
+}
+
+int workload_generate(const MapDef *map, unsigned long long seed, int count,
+                      int bucket_width, Query *out) {
+    int total = map->rows * map->cols;
+    int cols = map->cols;
+    MapInfo info;
+    map_info_compute(map, &info);
+    int ncomp = info.components;
+    const int *comp = info.comp, *comp_size = info.comp_size;
+
+    /* Group open cells by component: cells[] sorted by component,
+     * comp_start[k]..comp_start[k+1] is component k */
+    int *comp_start = calloc(ncomp + 1, sizeof(int));
+    int *cells = malloc(total * sizeof(int));
+    for (int k = 0; k < ncomp; k++)
+        comp_start[k + 1] = comp_start[k] + comp_size[k];
+    int open = comp_start[ncomp];
+    int *fill = calloc(ncomp + 1, sizeof(int));
+    for (int i = 0; i < total; i++)
+        if (comp[i] >= 0)
+            cells[comp_start[comp[i]] + fill[comp[i]]++] = i;
+
+    /* Only cells in components of size >= 2 can start a query */
+    int usable = 0;
+    for (int k = 0; k < ncomp; k++)
+        if (comp_size[k] >= 2) usable += comp_size[k];
+
+    int *dist = malloc(total * sizeof(int));
+    Rng rng = { seed };
+    int n = 0;
+
+    if (bucket_width < 1) bucket_width = 1;
+    while (usable > 0 && n < count) {
+        /* Uniform start over usable open cells, goal uniform in its component */
+        int s = cells[rng_below(&rng, open)];
+        int k = comp[s];
+        if (comp_size[k] < 2) continue;
+        int g = cells[comp_start[k] + rng_below(&rng, comp_size[k])];
+        if (g == s) continue;
+
+        bfs_distances(map, s, dist);
+        Query *q = &out[n++];
+        q->start_r = s / cols;
+        q->start_c = s % cols;
+        q->end_r = g / cols;
+        q->end_c = g % cols;
+        q->opt_len = dist[g];
+        q->bucket = dist[g] / bucket_width;
+        q->ref_len = 0.0;
+    }
+
+    free(dist);
+    free(fill);
+    free(cells);
+    free(comp_start);
+    map_info_free(&info);
+    return n;
+}
@@ -0,0 +1,57 @@
+/*
+ * workload.h — Random start/goal query workloads
+ *
+ * Samples reproducible (seeded) start/goal pairs from the same connected
+ * component of a map and buckets them by optimal 4-connected path length,
+ * in the spirit of the Moving AI scenario buckets.
+ */
+
+#ifndef WORKLOAD_H
+#define WORKLOAD_H
+
+#include "algo.h"
+#include "map_info.h"
+
+typedef struct {
+    int start_r, start_c, end_r, end_c;
+    int opt_len;   /* optimal 4-connected path cost (BFS) */
+    int bucket;    /* opt_len / bucket_width, or the scenario's bucket */
+    double ref_len; /* external reference length (.scen octile optimum), 0 = none */
+} Query;
+
+/* Deterministic PRNG (splitmix64) so every algorithm sees the same queries */
+typedef struct {
+    unsigned long long s;
+} Rng;
+
+static inline unsigned long long rng_next(Rng *r) {
+    unsigned long long z = (r->s += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+/* Uniform integer in [0, n) */
+static inline int rng_below(Rng *r, int n) {
+    return (int)(rng_next(r) % (unsigned long long)n);
+}
+
+/* BFS distances from src over open cells (-1 = unreachable) */
+void bfs_distances(const MapDef *map, int src, int *dist);
+
+/* Generate `count` queries into out[]; returns number generated (0 if the
+ * map has no component with two or more open cells). */
+int workload_generate(const MapDef *map, unsigned long long seed, int count,
+                      int bucket_width, Query *out);
+
+/* Copy of `map` with start/end replaced by the query's */
+static inline MapDef query_map(const MapDef *map, const Query *q) {
+    MapDef m = *map;
+    m.start_r = q->start_r;
+    m.start_c = q->start_c;
+    m.end_r = q->end_r;
+    m.end_c = q->end_c;
+    return m;
+}
+
+#endif /* WORKLOAD_H */